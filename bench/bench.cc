@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <batch.hh>
+#include <blockcache.hh>
+#include <cpu.hh>
+#include <fork.hh>
+#include <lockstep.hh>
+#include <memory.hh>
+#include <trace.hh>
+#include <vectorbatch.hh>
+#include "workloads.hh"
+
+struct Measurement
+{
+    std::string workload;
+    std::string engine;
+    u64 instructions;
+    u64 cycles;
+    double seconds;
+};
+
+struct Cost
+{
+    std::string name;
+    double nanoseconds;
+};
+
+static constexpr double MinimumSeconds = 0.25;
+
+static auto Start(CPU& cpu) -> void
+{
+    Registers registers = cpu.GetRegisters();
+    registers.PC = 0x0600;
+    cpu.SetRegisters(registers);
+}
+
+template <typename T>
+static auto Keep(T& value) -> void
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+static auto Measure(const Workload& workload, const char* name, const Engine& engine) -> Measurement
+{
+    Image image(0x0600, workload.program);
+    Measurement measurement = { workload.name, name, 0, 0, 0.0 };
+
+    auto start = std::chrono::steady_clock::now();
+    while (measurement.seconds < MinimumSeconds)
+    {
+        CPU cpu;
+        Memory memory;
+        memory.Map(image);
+        Start(cpu);
+        RunResult result = engine(cpu, memory, std::numeric_limits<u64>::max());
+        measurement.instructions += result.instructions;
+        measurement.cycles += result.cycles;
+        measurement.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return measurement;
+}
+
+template <typename Body>
+static auto Time(const char* name, u32 count, Body body) -> Cost
+{
+    auto start = std::chrono::steady_clock::now();
+    for (u32 index = 0; index < count; index++)
+    {
+        body();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return { name, std::chrono::duration<double, std::nano>(end - start).count() / count };
+}
+
+static auto PrintText(const std::vector<Measurement>& measurements, const std::vector<Cost>& costs) -> void
+{
+    for (const Measurement& measurement : measurements)
+    {
+        std::printf("%-16s %-32s %10llu instructions in %.3f s: %8.2f M instructions/s, %8.2f emulated MHz\n", measurement.workload.c_str(), measurement.engine.c_str(), measurement.instructions, measurement.seconds, measurement.instructions / measurement.seconds / 1e6, measurement.cycles / measurement.seconds / 1e6);
+    }
+
+    for (const Cost& cost : costs)
+    {
+        std::printf("%-45s %10.1f ns\n", cost.name.c_str(), cost.nanoseconds);
+    }
+}
+
+static auto PrintJson(const std::vector<Measurement>& measurements, const std::vector<Cost>& costs) -> void
+{
+    std::printf("{\n  \"measurements\": [\n");
+    for (u64 index = 0; index < measurements.size(); index++)
+    {
+        const Measurement& measurement = measurements[index];
+        std::printf("    { \"workload\": \"%s\", \"engine\": \"%s\", \"instructions\": %llu, \"cycles\": %llu, \"seconds\": %.6f, \"instructions_per_second\": %.0f, \"emulated_mhz\": %.3f }%s\n", measurement.workload.c_str(), measurement.engine.c_str(), measurement.instructions, measurement.cycles, measurement.seconds, measurement.instructions / measurement.seconds, measurement.cycles / measurement.seconds / 1e6, index + 1 < measurements.size() ? "," : "");
+    }
+
+    std::printf("  ],\n  \"costs\": [\n");
+    for (u64 index = 0; index < costs.size(); index++)
+    {
+        const Cost& cost = costs[index];
+        std::printf("    { \"name\": \"%s\", \"nanoseconds\": %.1f }%s\n", cost.name.c_str(), cost.nanoseconds, index + 1 < costs.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+auto main(int argc, char** argv) -> int
+{
+    bool json = false;
+    for (int index = 1; index < argc; index++)
+    {
+        if (std::string_view(argv[index]) == "--json")
+        {
+            json = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Engine interpreter = [](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        return cpu.RunInstructions(memory, instructions);
+    };
+
+    Engine slices = [](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        RunResult total = { StopReason::CycleLimit, 0, 0 };
+        while (total.reason == StopReason::CycleLimit)
+        {
+            RunResult result = cpu.RunFor(memory, instructions - total.instructions, 1000);
+            total.reason = result.reason;
+            total.instructions += result.instructions;
+            total.cycles += result.cycles;
+        }
+        return total;
+    };
+
+    Trace trace;
+    Engine traced = [&trace](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        return cpu.RunFor(memory, instructions, std::numeric_limits<u64>::max(), trace);
+    };
+
+    BlockCache cache;
+    Engine blocks = [&cache](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        return cache.RunInstructions(cpu, memory, instructions);
+    };
+
+    BlockCache jit;
+    jit.SetJitEnabled(true);
+    Engine compiled = [&jit](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        return jit.RunInstructions(cpu, memory, instructions);
+    };
+
+    std::vector<Measurement> measurements;
+    for (const Workload& workload : Workloads)
+    {
+        measurements.push_back(Measure(workload, "interpreter", interpreter));
+        measurements.push_back(Measure(workload, "interpreter, 1000-cycle slices", slices));
+        measurements.push_back(Measure(workload, "interpreter, traced", traced));
+        measurements.push_back(Measure(workload, "block cache", blocks));
+
+        if (!jit.IsJitEnabled())
+        {
+            continue;
+        }
+
+        Lockstep lockstep(interpreter, compiled, 1000);
+        std::optional<Divergence> divergence = lockstep.Run(Image(0x0600, workload.program), 0x0600, std::numeric_limits<u64>::max());
+        if (divergence.has_value())
+        {
+            std::fprintf(stderr, "%s: jit diverges from the interpreter after %llu instructions: PC $%04X/$%04X, PS $%02X/$%02X, cycles %llu/%llu\n", workload.name, divergence->instructions, divergence->expected.PC, divergence->actual.PC, divergence->expected.PS, divergence->actual.PS, divergence->expectedCycles, divergence->actualCycles);
+            return 1;
+        }
+        measurements.push_back(Measure(workload, "jit", compiled));
+    }
+
+    auto image = std::make_shared<const Image>(0x0600, CounterProgram);
+    std::vector<Job> jobs(2000, Job{ image, 0x0600, 100000 });
+    for (u32 threads : { 1u, std::max(1u, std::thread::hardware_concurrency()) })
+    {
+        Batch batch(threads);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<JobResult> results = batch.Run(jobs);
+        auto end = std::chrono::steady_clock::now();
+
+        Measurement measurement = { "counter", "batch of " + std::to_string(jobs.size()) + " jobs, " + std::to_string(threads) + " threads", 0, 0, std::chrono::duration<double>(end - start).count() };
+        for (const JobResult& result : results)
+        {
+            measurement.instructions += result.run.instructions;
+            measurement.cycles += result.run.cycles;
+        }
+        measurements.push_back(measurement);
+    }
+
+    for (u32 threads : { 1u, std::max(1u, std::thread::hardware_concurrency()) })
+    {
+        for (u32 lanes : { 8u, 16u, 32u })
+        {
+            VectorBatch batch(lanes, threads);
+            auto start = std::chrono::steady_clock::now();
+            std::vector<JobResult> results = batch.Run(jobs);
+            auto end = std::chrono::steady_clock::now();
+
+            Measurement measurement = { "counter", "vector batch of " + std::to_string(jobs.size()) + " jobs, " + std::to_string(lanes) + " lanes, " + std::to_string(threads) + " threads", 0, 0, std::chrono::duration<double>(end - start).count() };
+            for (const JobResult& result : results)
+            {
+                measurement.instructions += result.run.instructions;
+                measurement.cycles += result.run.cycles;
+            }
+            measurements.push_back(measurement);
+        }
+    }
+
+    constexpr u32 count = 100000;
+    std::vector<Cost> costs;
+    costs.push_back(Time("CPU construction", count, []
+    {
+        CPU cpu;
+        Keep(cpu);
+    }));
+    costs.push_back(Time("Memory construction", count, []
+    {
+        Memory memory;
+        Keep(memory);
+    }));
+
+    CPU cpu;
+    costs.push_back(Time("CPU Reset", count, [&cpu]
+    {
+        cpu.Reset();
+        Keep(cpu);
+    }));
+
+    Memory memory;
+    costs.push_back(Time("Memory Reset", count, [&memory]
+    {
+        memory.Reset();
+        Keep(memory);
+    }));
+    costs.push_back(Time("Memory Map of a shared image", count, [&memory, &image]
+    {
+        memory.Map(*image);
+        Keep(memory);
+    }));
+    costs.push_back(Time("instance creation with a shared image", count, [&image]
+    {
+        CPU cpu;
+        Memory memory;
+        memory.Map(*image);
+        Start(cpu);
+        cpu.RunInstructions(memory, 1);
+    }));
+
+    memory.Map(*image);
+    Start(cpu);
+    cpu.RunInstructions(memory, 1000);
+    Fork fork(cpu, memory);
+    costs.push_back(Time("Fork Spawn of a new machine", count, [&fork]
+    {
+        std::unique_ptr<Machine> machine = fork.Spawn();
+        Keep(*machine);
+    }));
+
+    Machine machine;
+    costs.push_back(Time("Fork Spawn into an existing machine", count, [&fork, &machine]
+    {
+        fork.Spawn(machine.cpu, machine.memory);
+        Keep(machine);
+    }));
+
+    if (json)
+    {
+        PrintJson(measurements, costs);
+    }
+    else
+    {
+        PrintText(measurements, costs);
+    }
+
+    return 0;
+}
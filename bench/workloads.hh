@@ -0,0 +1,225 @@
+#pragma once
+
+#include <span>
+#include <core.hh>
+
+static constexpr u8 CounterProgram[] = {
+    0xA0, 0x00,       // 0600: LDY #$00
+    0xA2, 0x00,       // 0602: LDX #$00
+    0xA5, 0x10,       // 0604: LDA $10
+    0x69, 0x01,       // 0606: ADC #$01
+    0x85, 0x10,       // 0608: STA $10
+    0xE8,             // 060A: INX
+    0xF0, 0x03,       // 060B: BEQ $0610
+    0x4C, 0x04, 0x06, // 060D: JMP $0604
+    0xC8,             // 0610: INY
+    0xF0, 0x03,       // 0611: BEQ $0616
+    0x4C, 0x02, 0x06, // 0613: JMP $0602
+    0x00,             // 0616: BRK
+};
+
+static constexpr u8 FlagProgram[] = {
+    0xA2, 0x00,       // 0600: LDX #$00
+    0xA0, 0x00,       // 0602: LDY #$00
+    0x8A,             // 0604: TXA
+    0x29, 0x0F,       // 0605: AND #$0F
+    0x49, 0x55,       // 0607: EOR #$55
+    0xC9, 0x40,       // 0609: CMP #$40
+    0x69, 0x03,       // 060B: ADC #$03
+    0xE9, 0x01,       // 060D: SBC #$01
+    0x24, 0x10,       // 060F: BIT $10
+    0x2A,             // 0611: ROL A
+    0x4A,             // 0612: LSR A
+    0xE8,             // 0613: INX
+    0xF0, 0x03,       // 0614: BEQ $0619
+    0x4C, 0x04, 0x06, // 0616: JMP $0604
+    0xC8,             // 0619: INY
+    0xF0, 0x03,       // 061A: BEQ $061F
+    0x4C, 0x04, 0x06, // 061C: JMP $0604
+    0x00,             // 061F: BRK
+};
+
+static constexpr u8 CopyProgram[] = {
+    0xA9, 0x40,       // 0600: LDA #$40
+    0x85, 0xF0,       // 0602: STA $F0
+    0xA0, 0x00,       // 0604: LDY #$00
+    0xB9, 0x00, 0x20, // 0606: LDA $2000,Y
+    0x99, 0x00, 0x30, // 0609: STA $3000,Y
+    0xC8,             // 060C: INY
+    0xF0, 0x03,       // 060D: BEQ $0612
+    0x4C, 0x06, 0x06, // 060F: JMP $0606
+    0xC6, 0xF0,       // 0612: DEC $F0
+    0xF0, 0x03,       // 0614: BEQ $0619
+    0x4C, 0x04, 0x06, // 0616: JMP $0604
+    0x00,             // 0619: BRK
+};
+
+static constexpr u8 ArithmeticProgram[] = {
+    0xA9, 0x10,       // 0600: LDA #$10
+    0x85, 0xF0,       // 0602: STA $F0
+    0xA0, 0x00,       // 0604: LDY #$00
+    0x84, 0xF1,       // 0606: STY $F1
+    0x84, 0xF2,       // 0608: STY $F2
+    0xA9, 0x00,       // 060A: LDA #$00
+    0x85, 0xF3,       // 060C: STA $F3
+    0x85, 0xF4,       // 060E: STA $F4
+    0xA2, 0x08,       // 0610: LDX #$08
+    0x46, 0xF1,       // 0612: LSR $F1
+    0x90, 0x07,       // 0614: BCC $061D
+    0x18,             // 0616: CLC
+    0xA5, 0xF4,       // 0617: LDA $F4
+    0x65, 0xF2,       // 0619: ADC $F2
+    0x85, 0xF4,       // 061B: STA $F4
+    0x66, 0xF4,       // 061D: ROR $F4
+    0x66, 0xF3,       // 061F: ROR $F3
+    0xCA,             // 0621: DEX
+    0xF0, 0x03,       // 0622: BEQ $0627
+    0x4C, 0x12, 0x06, // 0624: JMP $0612
+    0x84, 0xF5,       // 0627: STY $F5
+    0xA5, 0xF3,       // 0629: LDA $F3
+    0x85, 0xF6,       // 062B: STA $F6
+    0xA9, 0x07,       // 062D: LDA #$07
+    0x85, 0xF7,       // 062F: STA $F7
+    0xA9, 0x00,       // 0631: LDA #$00
+    0xA2, 0x10,       // 0633: LDX #$10
+    0x06, 0xF5,       // 0635: ASL $F5
+    0x26, 0xF6,       // 0637: ROL $F6
+    0x2A,             // 0639: ROL A
+    0xC5, 0xF7,       // 063A: CMP $F7
+    0x90, 0x04,       // 063C: BCC $0642
+    0xE5, 0xF7,       // 063E: SBC $F7
+    0xE6, 0xF5,       // 0640: INC $F5
+    0xCA,             // 0642: DEX
+    0xF0, 0x03,       // 0643: BEQ $0648
+    0x4C, 0x35, 0x06, // 0645: JMP $0635
+    0xC8,             // 0648: INY
+    0xF0, 0x03,       // 0649: BEQ $064E
+    0x4C, 0x06, 0x06, // 064B: JMP $0606
+    0xC6, 0xF0,       // 064E: DEC $F0
+    0xF0, 0x03,       // 0650: BEQ $0655
+    0x4C, 0x04, 0x06, // 0652: JMP $0604
+    0x00,             // 0655: BRK
+};
+
+static constexpr u8 SortProgram[] = {
+    0xA9, 0x10,       // 0600: LDA #$10
+    0x85, 0xF1,       // 0602: STA $F1
+    0xA2, 0x00,       // 0604: LDX #$00
+    0x8A,             // 0606: TXA
+    0x49, 0x3F,       // 0607: EOR #$3F
+    0x9D, 0x00, 0x20, // 0609: STA $2000,X
+    0xE8,             // 060C: INX
+    0xE0, 0x40,       // 060D: CPX #$40
+    0xF0, 0x03,       // 060F: BEQ $0614
+    0x4C, 0x06, 0x06, // 0611: JMP $0606
+    0xA9, 0x00,       // 0614: LDA #$00
+    0x85, 0xF0,       // 0616: STA $F0
+    0xA2, 0x00,       // 0618: LDX #$00
+    0xBD, 0x00, 0x20, // 061A: LDA $2000,X
+    0xDD, 0x01, 0x20, // 061D: CMP $2001,X
+    0x90, 0x10,       // 0620: BCC $0632
+    0xF0, 0x0E,       // 0622: BEQ $0632
+    0xBC, 0x01, 0x20, // 0624: LDY $2001,X
+    0x9D, 0x01, 0x20, // 0627: STA $2001,X
+    0x98,             // 062A: TYA
+    0x9D, 0x00, 0x20, // 062B: STA $2000,X
+    0xA9, 0x01,       // 062E: LDA #$01
+    0x85, 0xF0,       // 0630: STA $F0
+    0xE8,             // 0632: INX
+    0xE0, 0x3F,       // 0633: CPX #$3F
+    0xF0, 0x03,       // 0635: BEQ $063A
+    0x4C, 0x1A, 0x06, // 0637: JMP $061A
+    0xA5, 0xF0,       // 063A: LDA $F0
+    0xF0, 0x03,       // 063C: BEQ $0641
+    0x4C, 0x14, 0x06, // 063E: JMP $0614
+    0xC6, 0xF1,       // 0641: DEC $F1
+    0xF0, 0x03,       // 0643: BEQ $0648
+    0x4C, 0x04, 0x06, // 0645: JMP $0604
+    0x00,             // 0648: BRK
+};
+
+static constexpr u8 ChecksumProgram[] = {
+    0xA9, 0x20,       // 0600: LDA #$20
+    0x85, 0xF0,       // 0602: STA $F0
+    0xA9, 0xFF,       // 0604: LDA #$FF
+    0x85, 0xF2,       // 0606: STA $F2
+    0x85, 0xF3,       // 0608: STA $F3
+    0xA0, 0x00,       // 060A: LDY #$00
+    0xB9, 0x00, 0x06, // 060C: LDA $0600,Y
+    0x45, 0xF3,       // 060F: EOR $F3
+    0x85, 0xF3,       // 0611: STA $F3
+    0xA2, 0x08,       // 0613: LDX #$08
+    0x06, 0xF2,       // 0615: ASL $F2
+    0x26, 0xF3,       // 0617: ROL $F3
+    0x90, 0x0C,       // 0619: BCC $0627
+    0xA5, 0xF3,       // 061B: LDA $F3
+    0x49, 0x10,       // 061D: EOR #$10
+    0x85, 0xF3,       // 061F: STA $F3
+    0xA5, 0xF2,       // 0621: LDA $F2
+    0x49, 0x21,       // 0623: EOR #$21
+    0x85, 0xF2,       // 0625: STA $F2
+    0xCA,             // 0627: DEX
+    0xF0, 0x03,       // 0628: BEQ $062D
+    0x4C, 0x15, 0x06, // 062A: JMP $0615
+    0xC8,             // 062D: INY
+    0xF0, 0x03,       // 062E: BEQ $0633
+    0x4C, 0x0C, 0x06, // 0630: JMP $060C
+    0xC6, 0xF0,       // 0633: DEC $F0
+    0xF0, 0x03,       // 0635: BEQ $063A
+    0x4C, 0x04, 0x06, // 0637: JMP $0604
+    0x00,             // 063A: BRK
+};
+
+static constexpr u8 StateMachineProgram[] = {
+    0xA9, 0x80,       // 0600: LDA #$80
+    0x85, 0xF0,       // 0602: STA $F0
+    0xA2, 0x00,       // 0604: LDX #$00
+    0xA0, 0x00,       // 0606: LDY #$00
+    0xB9, 0x00, 0x06, // 0608: LDA $0600,Y
+    0xC9, 0x40,       // 060B: CMP #$40
+    0x90, 0x0F,       // 060D: BCC $061E
+    0xC9, 0x80,       // 060F: CMP #$80
+    0x90, 0x13,       // 0611: BCC $0626
+    0xC9, 0xC0,       // 0613: CMP #$C0
+    0x90, 0x16,       // 0615: BCC $062D
+    0x8A,             // 0617: TXA
+    0x49, 0x03,       // 0618: EOR #$03
+    0xAA,             // 061A: TAX
+    0x4C, 0x36, 0x06, // 061B: JMP $0636
+    0xE0, 0x02,       // 061E: CPX #$02
+    0xF0, 0x12,       // 0620: BEQ $0634
+    0xE8,             // 0622: INX
+    0x4C, 0x36, 0x06, // 0623: JMP $0636
+    0x8A,             // 0626: TXA
+    0xF0, 0x0D,       // 0627: BEQ $0636
+    0xCA,             // 0629: DEX
+    0x4C, 0x36, 0x06, // 062A: JMP $0636
+    0xF6, 0xE0,       // 062D: INC $E0,X
+    0xA2, 0x02,       // 062F: LDX #$02
+    0x4C, 0x36, 0x06, // 0631: JMP $0636
+    0xA2, 0x00,       // 0634: LDX #$00
+    0xE6, 0xE4,       // 0636: INC $E4
+    0xC8,             // 0638: INY
+    0xF0, 0x03,       // 0639: BEQ $063E
+    0x4C, 0x08, 0x06, // 063B: JMP $0608
+    0xC6, 0xF0,       // 063E: DEC $F0
+    0xF0, 0x03,       // 0640: BEQ $0645
+    0x4C, 0x04, 0x06, // 0642: JMP $0604
+    0x00,             // 0645: BRK
+};
+
+struct Workload
+{
+    const char* name;
+    std::span<const u8> program;
+};
+
+static constexpr Workload Workloads[] = {
+    { "counter", CounterProgram },
+    { "flags", FlagProgram },
+    { "memcpy", CopyProgram },
+    { "multiply-divide", ArithmeticProgram },
+    { "sort", SortProgram },
+    { "crc16", ChecksumProgram },
+    { "state-machine", StateMachineProgram },
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include "core.hh"
+#include "cpu.hh"
+#include "memory.hh"
+#include "threadpool.hh"
+
+struct Job
+{
+    std::shared_ptr<const Image> image;
+    u16 entry;
+    u64 cycles;
+};
+
+struct JobResult
+{
+    RunResult run;
+    Registers registers;
+    u64 digest;
+};
+
+class Batch
+{
+  public:
+    explicit Batch(u32 threads = std::thread::hardware_concurrency());
+    ~Batch() = default;
+
+    auto Run(const std::vector<Job>& jobs) -> std::vector<JobResult>;
+    auto GetThreadCount() const -> u32;
+
+    static auto Execute(const Job& job) -> JobResult;
+    static auto Digest(const Memory& memory) -> u64;
+
+  private:
+    ThreadPool _pool;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "core.hh"
+#include "cpu.hh"
+#include "memory.hh"
+
+class Jit;
+
+class BlockCache
+{
+  public:
+    static constexpr u32 MaxBlockLength = 32;
+
+    struct Record
+    {
+        CPU::DecodedHandler handler;
+        u16 operand;
+        u8 opcode;
+        u8 length;
+        u8 cycles;
+        bool writes;
+        bool accesses;
+    };
+
+    using NativeCode = auto (*)(CPU* cpu, Memory* memory, const u32* generation) -> u64;
+
+    BlockCache(Variant variant = Variant::Nmos);
+    ~BlockCache();
+
+    auto Run(CPU& cpu, Memory& memory) -> void;
+    auto Step(CPU& cpu, Memory& memory) -> RunResult;
+    auto RunInstructions(CPU& cpu, Memory& memory, u64 instructions) -> RunResult;
+    auto RunCycles(CPU& cpu, Memory& memory, u64 cycles) -> RunResult;
+    auto RunFor(CPU& cpu, Memory& memory, u64 instructions, u64 cycles) -> RunResult;
+
+    auto Flush() -> void;
+    auto GetBlockCount() const -> u64;
+
+    auto SetJitEnabled(bool enabled) -> void;
+    auto IsJitEnabled() const -> bool;
+    auto GetCompiledBlockCount() const -> u64;
+    auto GetVariant() const -> Variant;
+
+  private:
+    struct Block;
+
+    struct Link
+    {
+        Block* block;
+        u32 generation;
+        u16 address;
+    };
+
+    struct Block
+    {
+        std::vector<Record> records;
+        NativeCode code;
+        u32 entries;
+        u64 maxCycles;
+        u16 address;
+        u16 end;
+        u8 first;
+        u8 last;
+        u32 versions[2];
+        u32 generation;
+        Link links[2];
+    };
+
+    using Page = std::array<std::unique_ptr<Block>, Memory::PageSize>;
+
+    std::array<std::unique_ptr<Page>, Memory::PageCount> _blocks;
+    u64 _count = 0;
+    u64 _compiled = 0;
+    u64 _memory = 0;
+    std::unique_ptr<Jit> _jit;
+    Variant _variant;
+    const Instruction* _instructions;
+    const CPU::Handler* _handlers;
+    const CPU::DecodedHandler* _decodedHandlers;
+
+    auto Lookup(Memory& memory, u16 address) -> Block*;
+    auto Follow(Memory& memory, Block* previous, u16 address) -> Block*;
+    auto Compile(Block& block) -> void;
+    auto Translate(Memory& memory, u16 address) -> std::unique_ptr<Block>;
+    static auto Writes(Instruction instruction) -> bool;
+    static auto Accesses(Instruction instruction) -> bool;
+    static auto EndsBlock(Operation operation) -> bool;
+};
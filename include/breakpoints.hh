@@ -0,0 +1,73 @@
+#pragma once
+
+#include <bitset>
+#include <optional>
+#include <vector>
+#include "core.hh"
+
+enum class Access : u8
+{
+    Read = 0x01,
+    Write = 0x02,
+    ReadWrite = 0x03,
+};
+
+class Breakpoints
+{
+  public:
+    static constexpr u32 AddressCount = 0x10000;
+
+    Breakpoints();
+    ~Breakpoints() = default;
+
+    auto Set(u16 address) -> void;
+    auto Remove(u16 address) -> void;
+    auto Watch(u16 address, Access access = Access::Write) -> void;
+    auto Unwatch(u16 address, Access access = Access::ReadWrite) -> void;
+    auto Clear() -> void;
+
+    auto IsSet(u16 address) const -> bool
+    {
+        return _breakpoints[address];
+    }
+
+    auto IsWatched(u16 address, Access access = Access::Write) const -> bool
+    {
+        return (_watchpoints[address] & static_cast<u8>(access)) != 0;
+    }
+
+    auto IsWatching() const -> bool
+    {
+        return _watching != 0;
+    }
+
+    auto GetWatchHit() const -> std::optional<u16>
+    {
+        return _hit;
+    }
+
+    auto GetWatchAccess() const -> Access
+    {
+        return _access;
+    }
+
+  private:
+    std::bitset<AddressCount> _breakpoints;
+    std::vector<u8> _watchpoints;
+    u32 _watching = 0;
+    std::optional<u16> _hit;
+    Access _access = Access::Write;
+    bool _triggered = false;
+
+    friend class CPU;
+
+    auto Check(u16 address, Access access) -> void
+    {
+        if (!_triggered && IsWatched(address, access)) [[unlikely]]
+        {
+            _hit = address;
+            _access = access;
+            _triggered = true;
+        }
+    }
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include "core.hh"
+
+class Coverage
+{
+  public:
+    static constexpr u32 MapSize = 0x10000;
+
+    Coverage();
+    ~Coverage() = default;
+
+    auto Clear() -> void;
+
+    auto GetEdges() const -> std::span<const u16>
+    {
+        return _edges;
+    }
+
+    auto GetCount(u16 edge) const -> u8
+    {
+        return _counts[edge];
+    }
+
+    static auto Edge(u16 from, u16 to) -> u16
+    {
+        return ((static_cast<u32>(from) << 16 | to) * 0x9E3779B1) >> 16;
+    }
+
+    static auto Bucket(u8 count) -> u8;
+
+  private:
+    std::vector<u8> _counts;
+    std::vector<u16> _edges;
+
+    friend class CPU;
+
+    auto Record(u16 from, u16 to) -> void
+    {
+        u8& count = _counts[Edge(from, to)];
+        if (count == 0) [[unlikely]]
+        {
+            _edges.push_back(Edge(from, to));
+        }
+        count += count != 0xFF;
+    }
+};
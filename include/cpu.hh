@@ -1,18 +1,146 @@
 #pragma once
 
+#include <limits>
+#include <optional>
+#include <type_traits>
 #include <utility>
-#include <core.hh>
-#include <memory.hh>
-#include <opcodes.hh>
+#include "core.hh"
+#include "interrupt.hh"
+#include "memory.hh"
+#include "opcodes.hh"
+
+enum class StopReason
+{
+    Break,
+    InstructionLimit,
+    CycleLimit,
+    IllegalOpcode,
+    Breakpoint,
+    Watchpoint,
+};
+
+class Breakpoints;
+class Coverage;
+class Profiler;
+class Trace;
+
+struct RunResult
+{
+    StopReason reason;
+    u64 instructions;
+    u64 cycles;
+};
+
+struct Registers
+{
+    u16 PC;
+    u8 SP;
+    u8 A;
+    u8 X;
+    u8 Y;
+    u8 PS;
+};
 
 class CPU
 {
   public:
+    static constexpr u16 NmiVector = 0xFFFA;
+    static constexpr u16 ResetVector = 0xFFFC;
+    static constexpr u16 IrqVector = 0xFFFE;
+
     CPU();
     ~CPU() = default;
 
     auto Reset() -> void;
-    auto Run(Memory& memory) -> void;
+    auto Reset(Memory& memory) -> void;
+    template <Variant variant = Variant::Nmos>
+    auto RunFor(Memory& memory, u64 instructions, u64 cycles) -> RunResult;
+    template <Variant variant = Variant::Nmos>
+    auto RunFor(Memory& memory, u64 instructions, u64 cycles, Profiler& profiler) -> RunResult;
+    template <Variant variant = Variant::Nmos>
+    auto RunFor(Memory& memory, u64 instructions, u64 cycles, Trace& trace) -> RunResult;
+    template <Variant variant = Variant::Nmos>
+    auto RunFor(Memory& memory, u64 instructions, u64 cycles, Coverage& coverage) -> RunResult;
+    template <Variant variant = Variant::Nmos>
+    auto RunFor(Memory& memory, u64 instructions, u64 cycles, Breakpoints& breakpoints) -> RunResult;
+
+    template <Variant variant = Variant::Nmos>
+    auto Run(Memory& memory) -> void
+    {
+        RunFor<variant>(memory, std::numeric_limits<u64>::max(), std::numeric_limits<u64>::max());
+    }
+
+    template <Variant variant = Variant::Nmos>
+    auto Step(Memory& memory) -> RunResult
+    {
+        return RunFor<variant>(memory, 1, std::numeric_limits<u64>::max());
+    }
+
+    template <Variant variant = Variant::Nmos>
+    auto RunInstructions(Memory& memory, u64 instructions) -> RunResult
+    {
+        return RunFor<variant>(memory, instructions, std::numeric_limits<u64>::max());
+    }
+
+    template <Variant variant = Variant::Nmos>
+    auto RunCycles(Memory& memory, u64 cycles) -> RunResult
+    {
+        return RunFor<variant>(memory, std::numeric_limits<u64>::max(), cycles);
+    }
+
+    template <Variant variant = Variant::Nmos>
+    auto Run(Memory& memory, Profiler& profiler) -> void
+    {
+        RunFor<variant>(memory, std::numeric_limits<u64>::max(), std::numeric_limits<u64>::max(), profiler);
+    }
+
+    template <Variant variant = Variant::Nmos>
+    auto Run(Memory& memory, Trace& trace) -> void
+    {
+        RunFor<variant>(memory, std::numeric_limits<u64>::max(), std::numeric_limits<u64>::max(), trace);
+    }
+
+    template <Variant variant = Variant::Nmos>
+    auto Run(Memory& memory, Coverage& coverage) -> void
+    {
+        RunFor<variant>(memory, std::numeric_limits<u64>::max(), std::numeric_limits<u64>::max(), coverage);
+    }
+
+    template <Variant variant = Variant::Nmos>
+    auto Run(Memory& memory, Breakpoints& breakpoints) -> RunResult
+    {
+        return RunFor<variant>(memory, std::numeric_limits<u64>::max(), std::numeric_limits<u64>::max(), breakpoints);
+    }
+
+    auto Attach(InterruptController& interrupts) -> void;
+    auto Detach() -> void;
+
+    auto GetRegisters() const -> Registers
+    {
+        return { PC, SP, A, X, Y, GetStatus() };
+    }
+
+    auto SetRegisters(const Registers& registers) -> void
+    {
+        PC = registers.PC;
+        SP = registers.SP;
+        A = registers.A;
+        X = registers.X;
+        Y = registers.Y;
+        SetStatus(registers.PS);
+        _jammed = false;
+        Unmask();
+    }
+
+    auto GetCycles() const -> u64
+    {
+        return _cycles;
+    }
+
+    auto SetCycles(u64 cycles) -> void
+    {
+        _cycles = cycles;
+    }
 
   private:
     u16 PC;
@@ -27,80 +155,311 @@ class CPU
         u8 PS;
         struct
         {
-            u8 CF : 1;
-            u8 ZF : 1;
+            u8 : 2;
             u8 IF : 1;
             u8 DF : 1;
             u8 BF : 1;
-            u8 : 1;
-            u8 VF : 1;
-            u8 NF : 1;
+            u8 : 3;
         };
     };
 
-    auto Fetch(Memory& memory, AddressingMode addressingMode = AddressingMode::Immediate) -> std::pair<u8, u16>;
-    auto Execute(Memory& memory, OperationCode opcode) -> void;
+    u8 _carry;
+    u8 _overflow;
+    u8 _zero;
+    u8 _negative;
+
+    u64 _cycles;
+    bool _jammed;
+
+    InterruptController* _interrupts = nullptr;
+    const u64* _deadline = &InterruptController::Never;
+
+    u8* _zeroPage = nullptr;
+    u8* _stack = nullptr;
+    u64 _layout = 0;
+
+    friend class BlockCache;
+    friend class Jit;
+    friend class VectorBatch;
+
+    using Handler = void (*)(CPU& cpu, Memory& memory);
+    using DecodedHandler = void (*)(CPU& cpu, Memory& memory, u16 operand);
+
+    template <Variant variant>
+    static auto Handlers() -> const Handler*;
+    template <Variant variant>
+    static auto DecodedHandlers() -> const DecodedHandler*;
+    static auto Handlers(Variant variant) -> const Handler*;
+    static auto DecodedHandlers(Variant variant) -> const DecodedHandler*;
+
+    template <Variant variant, typename Observer>
+    auto Loop(Memory& memory, u64 instructions, u64 cycles, Observer* observer) -> RunResult;
+
+    template <AddressingMode addressingMode>
+    auto Address(Memory& memory, u16 operand) -> u16;
+    template <AddressingMode addressingMode, bool pageCrossCycle = true>
+    auto Fetch(Memory& memory, u16 operand) -> std::pair<u8, u16>;
+    auto Address(Memory& memory, AddressingMode addressingMode, u16 operand) -> std::optional<u16>;
+    static auto PageCrossed(u16 from, u16 to) -> bool;
+    template <Variant variant>
+    auto Execute(Memory& memory, u8 opcode) -> void;
+    template <Variant variant>
+    auto Execute(Memory& memory, Profiler& profiler) -> void;
+    template <Variant variant>
+    auto Execute(Memory& memory, Trace& trace) -> void;
+    template <Variant variant>
+    auto Execute(Memory& memory, Coverage& coverage) -> void;
+    template <Variant variant>
+    auto Execute(Memory& memory, Breakpoints& breakpoints) -> void;
+    template <Variant variant, u8 opcode>
+    static auto Execute(CPU& cpu, Memory& memory) -> void;
+    template <Variant variant, u8 opcode>
+    static auto Dispatch(CPU& cpu, Memory& memory, u16 operand) -> void;
+
+    auto GetStatus() const -> u8
+    {
+        return (PS & 0x3C) | _carry | (_zero == 0) << 1 | _overflow << 6 | (_negative & 0x80);
+    }
+
+    auto SetStatus(u8 status) -> void
+    {
+        PS = status & 0x3C;
+        _carry = status & 0x01;
+        _zero = (status & 0x02) == 0;
+        _overflow = (status >> 6) & 0x01;
+        _negative = status & 0x80;
+    }
+    auto SetResult(u8 result) -> void;
+    template <Variant variant>
+    auto DecimalSum(u8 data) -> void;
+    template <Variant variant>
+    auto DecimalDifference(u8 data) -> void;
+    auto GetStopReason() const -> StopReason;
+
+    auto Poll(Memory& memory, Variant variant) -> void;
+    auto Unmask() -> void;
+    auto Interrupt(Memory& memory, u16 vector, u8 status, Variant variant) -> void;
+
+    auto Bind(Memory& memory) -> void
+    {
+        if (memory.GetLayout() != _layout) [[unlikely]]
+        {
+            _layout = memory.GetLayout();
+            _zeroPage = memory.GetDirectPage(0x00);
+            _stack = memory.GetDirectPage(0x01);
+        }
+    }
+
+    auto ReadZeroPage(Memory& memory, u8 address) -> u8
+    {
+        if (_zeroPage != nullptr) [[likely]]
+        {
+            return _zeroPage[address];
+        }
+        return memory.Read(address);
+    }
+
+    auto WriteZeroPage(Memory& memory, u8 address, u8 data) -> void
+    {
+        if (_zeroPage != nullptr) [[likely]]
+        {
+            _zeroPage[address] = data;
+            return;
+        }
+        memory.Write(address, data);
+    }
+
+    template <AddressingMode addressingMode>
+    auto Store(Memory& memory, u16 address, u8 data) -> void;
 
     auto Push(Memory& memory, u8 value) -> void;
     auto Pop(Memory& memory) -> u8;
 
     auto BranchIf(bool condition, u8 offset) -> void;
     auto Compare(u8 left, u8 right) -> void;
+    template <AddressingMode addressingMode>
+    auto StoreHigh(Memory& memory, u16 operand, u8 value) -> void;
+
+    template <Variant variant, AddressingMode addressingMode>
+    auto ADC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto AND(Memory& memory, u16 operand) -> void;
+    template <Variant variant, AddressingMode addressingMode>
+    auto ASL(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BCC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BCS(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BEQ(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BIT(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BMI(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BNE(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BPL(Memory& memory, u16 operand) -> void;
+    template <Variant variant, AddressingMode addressingMode>
+    auto BRK(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BVC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BVS(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto CLC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto CLD(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto CLI(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto CLV(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto CMP(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto CPX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto CPY(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto DEC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto DEX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto DEY(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto EOR(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto INC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto INX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto INY(Memory& memory, u16 operand) -> void;
+    template <Variant variant, AddressingMode addressingMode>
+    auto JMP(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto JSR(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto LDA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto LDX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto LDY(Memory& memory, u16 operand) -> void;
+    template <Variant variant, AddressingMode addressingMode>
+    auto LSR(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto NOP(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto ORA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto PHA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto PHP(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto PLA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto PLP(Memory& memory, u16 operand) -> void;
+    template <Variant variant, AddressingMode addressingMode>
+    auto ROL(Memory& memory, u16 operand) -> void;
+    template <Variant variant, AddressingMode addressingMode>
+    auto ROR(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto RTI(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto RTS(Memory& memory, u16 operand) -> void;
+    template <Variant variant, AddressingMode addressingMode>
+    auto SBC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SEC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SED(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SEI(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto STA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto STX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto STY(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TAX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TAY(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TSX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TXA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TXS(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TYA(Memory& memory, u16 operand) -> void;
+
+    template <AddressingMode addressingMode>
+    auto ALR(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto ANC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto ANE(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto ARR(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto DCP(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto ISC(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto JAM(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto LAS(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto LAX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto LXA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto RLA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto RRA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SAX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SBX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SHA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SHX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SHY(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SLO(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto SRE(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TAS(Memory& memory, u16 operand) -> void;
 
-    auto ADC(Memory& memory, AddressingMode addressingMode) -> void;
-    auto AND(Memory& memory, AddressingMode addressingMode) -> void;
-    auto ASL(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BCC(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BCS(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BEQ(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BIT(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BMI(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BNE(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BPL(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BRK(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BVC(Memory& memory, AddressingMode addressingMode) -> void;
-    auto BVS(Memory& memory, AddressingMode addressingMode) -> void;
-    auto CLC(Memory& memory, AddressingMode addressingMode) -> void;
-    auto CLD(Memory& memory, AddressingMode addressingMode) -> void;
-    auto CLI(Memory& memory, AddressingMode addressingMode) -> void;
-    auto CLV(Memory& memory, AddressingMode addressingMode) -> void;
-    auto CMP(Memory& memory, AddressingMode addressingMode) -> void;
-    auto CPX(Memory& memory, AddressingMode addressingMode) -> void;
-    auto CPY(Memory& memory, AddressingMode addressingMode) -> void;
-    auto DEC(Memory& memory, AddressingMode addressingMode) -> void;
-    auto DEX(Memory& memory, AddressingMode addressingMode) -> void;
-    auto DEY(Memory& memory, AddressingMode addressingMode) -> void;
-    auto EOR(Memory& memory, AddressingMode addressingMode) -> void;
-    auto INC(Memory& memory, AddressingMode addressingMode) -> void;
-    auto INX(Memory& memory, AddressingMode addressingMode) -> void;
-    auto INY(Memory& memory, AddressingMode addressingMode) -> void;
-    auto JMP(Memory& memory, AddressingMode addressingMode) -> void;
-    auto JSR(Memory& memory, AddressingMode addressingMode) -> void;
-    auto LDA(Memory& memory, AddressingMode addressingMode) -> void;
-    auto LDX(Memory& memory, AddressingMode addressingMode) -> void;
-    auto LDY(Memory& memory, AddressingMode addressingMode) -> void;
-    auto LSR(Memory& memory, AddressingMode addressingMode) -> void;
-    auto NOP(Memory& memory, AddressingMode addressingMode) -> void;
-    auto ORA(Memory& memory, AddressingMode addressingMode) -> void;
-    auto PHA(Memory& memory, AddressingMode addressingMode) -> void;
-    auto PHP(Memory& memory, AddressingMode addressingMode) -> void;
-    auto PLA(Memory& memory, AddressingMode addressingMode) -> void;
-    auto PLP(Memory& memory, AddressingMode addressingMode) -> void;
-    auto ROL(Memory& memory, AddressingMode addressingMode) -> void;
-    auto ROR(Memory& memory, AddressingMode addressingMode) -> void;
-    auto RTI(Memory& memory, AddressingMode addressingMode) -> void;
-    auto RTS(Memory& memory, AddressingMode addressingMode) -> void;
-    auto SBC(Memory& memory, AddressingMode addressingMode) -> void;
-    auto SEC(Memory& memory, AddressingMode addressingMode) -> void;
-    auto SED(Memory& memory, AddressingMode addressingMode) -> void;
-    auto SEI(Memory& memory, AddressingMode addressingMode) -> void;
-    auto STA(Memory& memory, AddressingMode addressingMode) -> void;
-    auto STX(Memory& memory, AddressingMode addressingMode) -> void;
-    auto STY(Memory& memory, AddressingMode addressingMode) -> void;
-    auto TAX(Memory& memory, AddressingMode addressingMode) -> void;
-    auto TAY(Memory& memory, AddressingMode addressingMode) -> void;
-    auto TSX(Memory& memory, AddressingMode addressingMode) -> void;
-    auto TXA(Memory& memory, AddressingMode addressingMode) -> void;
-    auto TXS(Memory& memory, AddressingMode addressingMode) -> void;
-    auto TYA(Memory& memory, AddressingMode addressingMode) -> void;
+    template <u8 bit>
+    auto BBR(Memory& memory, u16 operand) -> void;
+    template <u8 bit>
+    auto BBS(Memory& memory, u16 operand) -> void;
+    template <u8 bit>
+    auto RMB(Memory& memory, u16 operand) -> void;
+    template <u8 bit>
+    auto SMB(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto BRA(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto PHX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto PHY(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto PLX(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto PLY(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto STP(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto STZ(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TRB(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto TSB(Memory& memory, u16 operand) -> void;
+    template <AddressingMode addressingMode>
+    auto WAI(Memory& memory, u16 operand) -> void;
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "batch.hh"
+#include "blockcache.hh"
+#include "breakpoints.hh"
+#include "core.hh"
+#include "coverage.hh"
+#include "cpu.hh"
+#include "device.hh"
+#include "disassembler.hh"
+#include "fork.hh"
+#include "fuzzer.hh"
+#include "gdbserver.hh"
+#include "interrupt.hh"
+#include "jit.hh"
+#include "loader.hh"
+#include "lockstep.hh"
+#include "memory.hh"
+#include "opcodes.hh"
+#include "profiler.hh"
+#include "snapshot.hh"
+#include "threadpool.hh"
+#include "timeline.hh"
+#include "trace.hh"
+#include "vectorbatch.hh"
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <functional>
+#include "core.hh"
+
+class Device
+{
+  public:
+    virtual ~Device() = default;
+
+    virtual auto Read(u16 address) -> u8 = 0;
+    virtual auto Write(u16 address, u8 data) -> void = 0;
+};
+
+class CallbackDevice : public Device
+{
+  public:
+    using ReadCallback = std::function<auto(u16 address) -> u8>;
+    using WriteCallback = std::function<auto(u16 address, u8 data) -> void>;
+
+    CallbackDevice(ReadCallback read, WriteCallback write);
+    ~CallbackDevice() override = default;
+
+    auto Read(u16 address) -> u8 override;
+    auto Write(u16 address, u8 data) -> void override;
+
+  private:
+    ReadCallback _read;
+    WriteCallback _write;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include "core.hh"
+#include "memory.hh"
+#include "opcodes.hh"
+
+class Disassembler
+{
+  public:
+    static auto Disassemble(u16 address, u8 opcode, u16 operand, Variant variant = Variant::Nmos) -> std::string;
+    static auto Disassemble(const Memory& memory, u16 address, Variant variant = Variant::Nmos) -> std::string;
+};
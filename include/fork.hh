@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "core.hh"
+#include "cpu.hh"
+#include "memory.hh"
+
+struct Machine
+{
+    CPU cpu;
+    Memory memory;
+};
+
+class Fork
+{
+  public:
+    Fork(const CPU& cpu, Memory& memory);
+    ~Fork() = default;
+
+    auto Spawn() const -> std::unique_ptr<Machine>;
+    auto Spawn(u32 count) const -> std::vector<std::unique_ptr<Machine>>;
+    auto Spawn(CPU& cpu, Memory& memory) const -> void;
+
+    auto GetRegisters() const -> Registers;
+    auto GetCycles() const -> u64;
+
+  private:
+    Registers _registers;
+    u64 _cycles;
+    std::shared_ptr<const Memory::Pages> _pages;
+};
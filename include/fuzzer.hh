@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "core.hh"
+#include "coverage.hh"
+#include "cpu.hh"
+#include "fork.hh"
+#include "memory.hh"
+#include "threadpool.hh"
+
+struct FuzzRegion
+{
+    u16 address;
+    u16 size;
+};
+
+struct FuzzOptions
+{
+    Variant variant = Variant::Nmos;
+    u64 instructions = 100000;
+    u32 threads = std::thread::hardware_concurrency();
+    u64 seed = 0;
+};
+
+struct FuzzFinding
+{
+    std::vector<u8> input;
+    StopReason reason;
+    u16 PC;
+};
+
+struct FuzzStatistics
+{
+    u64 executions;
+    u64 edges;
+    u64 corpus;
+    u64 findings;
+    u64 timeouts;
+    double seconds;
+};
+
+class Fuzzer
+{
+  public:
+    using Report = std::function<void(const FuzzStatistics& statistics)>;
+
+    Fuzzer(const CPU& cpu, Memory& memory, std::vector<FuzzRegion> regions, const FuzzOptions& options = {});
+    ~Fuzzer() = default;
+
+    Fuzzer(const Fuzzer&) = delete;
+    auto operator=(const Fuzzer&) -> Fuzzer& = delete;
+
+    auto AddSeed(std::span<const u8> input) -> void;
+    auto Run(std::chrono::milliseconds duration, const Report& report = {}, std::chrono::milliseconds interval = std::chrono::seconds(1)) -> FuzzStatistics;
+    auto Stop() -> void;
+
+    auto GetStatistics() const -> FuzzStatistics;
+    auto GetCorpus() const -> std::vector<std::vector<u8>>;
+    auto GetFindings() const -> std::vector<FuzzFinding>;
+    auto GetInputSize() const -> u32;
+    auto GetThreadCount() const -> u32;
+
+  private:
+    struct alignas(64) Counters
+    {
+        std::atomic<u64> executions;
+        std::atomic<u64> timeouts;
+    };
+
+    struct Worker;
+
+    Fork _fork;
+    std::vector<FuzzRegion> _regions;
+    FuzzOptions _options;
+    u32 _size;
+
+    std::unique_ptr<std::atomic<u8>[]> _seen;
+    std::atomic<u64> _edges;
+
+    mutable std::mutex _mutex;
+    std::vector<std::vector<u8>> _corpus;
+    std::map<std::pair<StopReason, u16>, std::vector<u8>> _findings;
+    u64 _calibrated;
+
+    std::chrono::steady_clock::duration _elapsed;
+    std::chrono::steady_clock::time_point _start;
+    bool _running;
+
+    ThreadPool _pool;
+    std::unique_ptr<Counters[]> _counters;
+    std::atomic<bool> _stopping;
+
+    auto Fuzz(u32 index) -> void;
+    auto Execute(Worker& worker, std::span<const u8> input) -> bool;
+    auto Evaluate(const Coverage& coverage) -> bool;
+    auto Mutate(Worker& worker, std::vector<u8>& input, std::span<const u8> other) -> void;
+};
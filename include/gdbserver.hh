@@ -0,0 +1,53 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include "breakpoints.hh"
+#include "core.hh"
+#include "cpu.hh"
+#include "memory.hh"
+#include "timeline.hh"
+
+class GdbServer
+{
+  public:
+    static constexpr u64 Slice = 0x100000;
+
+    GdbServer(CPU& cpu, Memory& memory, Variant variant = Variant::Nmos);
+    ~GdbServer();
+
+    GdbServer(const GdbServer&) = delete;
+    auto operator=(const GdbServer&) -> GdbServer& = delete;
+
+    auto Listen(const std::string& address) -> void;
+    auto Serve() -> void;
+
+  private:
+    CPU& _cpu;
+    Memory& _memory;
+    Timeline _timeline;
+    Breakpoints _breakpoints;
+
+    int _listener;
+    int _connection;
+    std::string _path;
+    std::string _input;
+    std::string _last;
+    std::string _stop;
+    bool _acknowledge;
+    bool _attached;
+
+    auto Receive() -> std::optional<std::string>;
+    auto Send(std::string_view data) -> void;
+    auto ReadByte() -> int;
+    auto Interrupted() -> bool;
+    auto Close() -> void;
+
+    auto Handle(const std::string& packet) -> std::optional<std::string>;
+    auto Query(const std::string& packet) -> std::string;
+    auto Resume(bool step) -> std::string;
+    auto Reverse(bool step) -> std::string;
+    auto Report(const RunResult& result) -> std::string;
+    auto Insert(const std::string& packet, bool insert) -> std::string;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <vector>
+#include "core.hh"
+
+class InterruptController
+{
+  public:
+    static constexpr u64 Never = std::numeric_limits<u64>::max();
+    static constexpr u32 IrqSourceCount = 32;
+
+    using EventId = u64;
+    using Callback = std::function<auto(u64 cycle) -> void>;
+
+    InterruptController() = default;
+    ~InterruptController() = default;
+
+    InterruptController(const InterruptController&) = delete;
+    auto operator=(const InterruptController&) -> InterruptController& = delete;
+
+    auto Reset() -> void;
+
+    auto Schedule(u64 cycle, Callback callback) -> EventId;
+    auto Cancel(EventId id) -> bool;
+    auto GetEventCount() const -> u64;
+
+    auto SetIrq(u32 source, bool asserted) -> void;
+    auto SetNmi(bool asserted) -> void;
+    auto TriggerNmi() -> void;
+
+    auto IsIrqAsserted() const -> bool
+    {
+        return _irq != 0;
+    }
+
+    auto IsNmiPending() const -> bool
+    {
+        return _nmi;
+    }
+
+    auto GetDeadline() const -> const u64&
+    {
+        return _deadline;
+    }
+
+  private:
+    struct Event
+    {
+        u64 cycle;
+        EventId id;
+        Callback callback;
+    };
+
+    std::vector<Event> _events;
+    EventId _next = 1;
+    u32 _irq = 0;
+    bool _nmiLine = false;
+    bool _nmi = false;
+    bool _masked = false;
+    u64 _deadline = Never;
+
+    friend class CPU;
+
+    auto Dispatch(u64 cycle) -> void;
+    auto Update() -> void;
+    static auto Later(const Event& left, const Event& right) -> bool;
+};
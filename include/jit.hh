@@ -0,0 +1,48 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include "blockcache.hh"
+#include "core.hh"
+#include "cpu.hh"
+#include "memory.hh"
+
+class Jit
+{
+  public:
+    static constexpr u32 Threshold = 16;
+    static constexpr u64 BufferSize = 4 << 20;
+
+    Jit();
+    ~Jit();
+
+    Jit(const Jit&) = delete;
+    auto operator=(const Jit&) -> Jit& = delete;
+
+    static auto IsSupported() -> bool;
+
+    auto Compile(u16 address, std::span<const BlockCache::Record> records, const Instruction* instructions) -> BlockCache::NativeCode;
+    auto Reset() -> void;
+    auto GetUsedBytes() const -> u64;
+    auto IsAvailable() const -> bool;
+    auto IsFull() const -> bool;
+
+  private:
+    u8* _buffer;
+    u64 _used;
+    bool _full;
+
+    auto Translate(std::vector<u8>& code, const BlockCache::Record& record, const Instruction& instruction, u16 pc) -> bool;
+    static auto Jumps(Operation operation) -> bool;
+    auto Call(std::vector<u8>& code, const BlockCache::Record& record) -> void;
+    auto SetResult(std::vector<u8>& code) -> void;
+    auto SetFlags(std::vector<u8>& code, u8 mask, u8 flags) -> void;
+    auto StorePC(std::vector<u8>& code, u16 pc) -> void;
+    auto AddCycles(std::vector<u8>& code, u64 cycles) -> void;
+
+    static auto Emit(std::vector<u8>& code, std::initializer_list<u8> bytes) -> void;
+    static auto Emit16(std::vector<u8>& code, u16 value) -> void;
+    static auto Emit32(std::vector<u8>& code, u32 value) -> void;
+    static auto Emit64(std::vector<u8>& code, u64 value) -> void;
+    static auto Patch32(std::vector<u8>& code, u64 position, u32 value) -> void;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+#include "core.hh"
+#include "memory.hh"
+
+enum class ImageFormat
+{
+    Binary,
+    IntelHex,
+    INes,
+};
+
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    auto GetData() const -> std::span<const u8>;
+
+  private:
+    const u8* _data;
+    u64 _size;
+    std::vector<u8> _buffer;
+};
+
+class Loader
+{
+  public:
+    static constexpr u64 INesHeaderSize = 16;
+    static constexpr u64 INesTrainerSize = 512;
+    static constexpr u64 INesBankSize = 0x4000;
+
+    static auto Detect(const std::filesystem::path& path) -> ImageFormat;
+    static auto Load(Image& image, const std::filesystem::path& path, u16 address = 0x0000) -> std::optional<u16>;
+    static auto Load(Image& image, const std::filesystem::path& path, ImageFormat format, u16 address = 0x0000) -> std::optional<u16>;
+
+  private:
+    static auto LoadBinary(Image& image, const std::shared_ptr<const MappedFile>& file, u64 offset, u64 size, u16 address) -> void;
+    static auto LoadIntelHex(Image& image, const MappedFile& file) -> std::optional<u16>;
+    static auto LoadINes(Image& image, const std::shared_ptr<const MappedFile>& file) -> void;
+    static auto ParseHex(std::span<const u8> text) -> u8;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include "core.hh"
+#include "cpu.hh"
+#include "memory.hh"
+
+using Engine = std::function<auto(CPU& cpu, Memory& memory, u64 instructions) -> RunResult>;
+
+struct Divergence
+{
+    u64 instructions;
+    Registers expected;
+    Registers actual;
+    u64 expectedCycles;
+    u64 actualCycles;
+    std::optional<u16> address;
+};
+
+class Lockstep
+{
+  public:
+    Lockstep(Engine reference, Engine candidate, u64 stride = 1);
+    ~Lockstep() = default;
+
+    auto Run(const Image& image, u16 entry, u64 instructions) -> std::optional<Divergence>;
+
+  private:
+    Engine _reference;
+    Engine _candidate;
+    u64 _stride;
+
+    static auto Compare(const Memory& expected, const Memory& actual) -> std::optional<u16>;
+};
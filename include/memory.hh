@@ -1,18 +1,148 @@
 #pragma once
 
-#include <core.hh>
+#include <array>
+#include <bitset>
+#include <memory>
+#include <span>
+#include <vector>
+#include "core.hh"
+#include "device.hh"
+
+class Image;
 
 class Memory
 {
   public:
+    static constexpr u32 PageSize = 0x100;
+    static constexpr u32 PageCount = 0x100;
+    static constexpr u32 DirectPageCount = 2;
+
+    using Page = std::array<u8, PageSize>;
+    using Pages = std::array<std::shared_ptr<const Page>, PageCount>;
+
     Memory();
     ~Memory() = default;
 
+    Memory(const Memory&) = delete;
+    auto operator=(const Memory&) -> Memory& = delete;
+
     auto Reset() -> void;
+    auto Map(const Image& image) -> void;
+    auto Attach(u16 first, u16 last, Device& device) -> void;
+    auto Detach(Device& device) -> void;
+    auto GetOwnedPageCount() const -> u32;
+    auto GetDirtyPages() const -> std::bitset<PageCount>;
+    auto GetPage(u8 page) const -> const u8*;
+
+    auto Capture() -> Pages;
+    auto Restore(const Pages& pages) -> void;
+    auto Inherit(std::shared_ptr<const Pages> pages) -> void;
+
+    auto MarkCode(u16 first, u16 last) -> void;
+    auto IsDevice(u8 page) const -> bool;
+
+    auto GetId() const -> u64
+    {
+        return _id;
+    }
+
+    auto GetCodeVersion(u8 page) const -> u32
+    {
+        return _code != nullptr ? _code->versions[page] : 0;
+    }
+
+    auto GetCodeGeneration() const -> const u32&
+    {
+        return _generation;
+    }
+
+    auto GetLayout() const -> u64
+    {
+        return _layout;
+    }
+
+    auto GetDirectPage(u8 page) const -> u8*
+    {
+        return _direct[page];
+    }
+
+    auto GetReadPage(u8 page) const -> const u8*
+    {
+        return _read[page];
+    }
+
+    auto Read(u16 address) const -> u8
+    {
+        const u8* page = _read[address >> 8];
+        if (page == nullptr) [[unlikely]]
+        {
+            return ReadDevice(address);
+        }
+        return page[address & 0xFF];
+    }
+
+    auto Write(u16 address, u8 data) -> void
+    {
+        u8* page = _write[address >> 8];
+        if (page == nullptr) [[unlikely]]
+        {
+            return WriteSlow(address, data);
+        }
+        page[address & 0xFF] = data;
+    }
+
+  private:
+    struct Mapping
+    {
+        u16 first;
+        u16 last;
+        Device* device;
+    };
+
+    struct Code
+    {
+        std::array<std::unique_ptr<std::bitset<PageSize>>, PageCount> pages;
+        std::array<u32, PageCount> versions = {};
+    };
+
+    static const Page Zero;
+
+    std::array<const u8*, PageCount> _read;
+    std::array<u8*, PageCount> _write;
+    std::array<std::unique_ptr<Page>, PageCount> _owned;
+    std::unique_ptr<Pages> _shared;
+    std::shared_ptr<const Pages> _base;
+    std::vector<Mapping> _mappings;
+    std::bitset<PageCount> _devices;
+    std::unique_ptr<Code> _code;
+    std::array<u8*, DirectPageCount> _direct = {};
+    u32 _generation = 0;
+    u64 _id;
+    u64 _layout = 0;
+
+    auto Backing(u8 page) const -> const u8*;
+    auto Remap(u8 page) -> void;
+    auto Replace(u8 page, std::shared_ptr<const Page> data) -> void;
+    auto Invalidate(u8 page) -> void;
+    auto IsCode(u8 page) const -> bool;
+    auto Share(u8 page, std::shared_ptr<const Page> data) -> void;
+    auto Own(u8 page) -> u8*;
+    auto ReadDevice(u16 address) const -> u8;
+    auto WriteSlow(u16 address, u8 data) -> void;
+};
+
+class Image
+{
+  public:
+    Image() = default;
+    Image(u16 address, std::span<const u8> data);
+    ~Image() = default;
 
-    auto Read(u16 address) const -> u8;
-    auto Write(u16 address, u8 data) -> void;
+    auto Write(u16 address, std::span<const u8> data) -> void;
+    auto SetPage(u8 page, std::shared_ptr<const Memory::Page> data) -> void;
+    auto GetPage(u8 page) const -> std::shared_ptr<const Memory::Page>;
 
   private:
-    u8 _data[0x10000];
+    std::array<std::shared_ptr<Memory::Page>, Memory::PageCount> _pages;
+    std::array<std::shared_ptr<const Memory::Page>, Memory::PageCount> _mapped;
 };
@@ -1,6 +1,15 @@
 #pragma once
 
-#include <core.hh>
+#include <array>
+#include <string_view>
+#include "core.hh"
+
+enum class Variant
+{
+    Nmos,
+    Cmos,
+    Strict,
+};
 
 enum class AddressingMode
 {
@@ -17,6 +26,103 @@ enum class AddressingMode
     Indirect,
     IndirectX,
     IndirectY,
+    ZeroPageIndirect,
+    AbsoluteIndexedIndirect,
+    ZeroPageRelative,
+};
+
+enum class Operation
+{
+    ADC,
+    AND,
+    ASL,
+    BCC,
+    BCS,
+    BEQ,
+    BIT,
+    BMI,
+    BNE,
+    BPL,
+    BRK,
+    BVC,
+    BVS,
+    CLC,
+    CLD,
+    CLI,
+    CLV,
+    CMP,
+    CPX,
+    CPY,
+    DEC,
+    DEX,
+    DEY,
+    EOR,
+    INC,
+    INX,
+    INY,
+    JMP,
+    JSR,
+    LDA,
+    LDX,
+    LDY,
+    LSR,
+    NOP,
+    ORA,
+    PHA,
+    PHP,
+    PLA,
+    PLP,
+    ROL,
+    ROR,
+    RTI,
+    RTS,
+    SBC,
+    SEC,
+    SED,
+    SEI,
+    STA,
+    STX,
+    STY,
+    TAX,
+    TAY,
+    TSX,
+    TXA,
+    TXS,
+    TYA,
+    ALR,
+    ANC,
+    ANE,
+    ARR,
+    DCP,
+    ISC,
+    JAM,
+    LAS,
+    LAX,
+    LXA,
+    RLA,
+    RRA,
+    SAX,
+    SBX,
+    SHA,
+    SHX,
+    SHY,
+    SLO,
+    SRE,
+    TAS,
+    BBR,
+    BBS,
+    BRA,
+    PHX,
+    PHY,
+    PLX,
+    PLY,
+    RMB,
+    SMB,
+    STP,
+    STZ,
+    TRB,
+    TSB,
+    WAI,
 };
 
 enum class OperationCode : u8
@@ -228,3 +334,664 @@ enum class OperationCode : u8
 
     TYA_Implied = 0x98,
 };
+
+constexpr auto Length(AddressingMode addressingMode) -> u8
+{
+    switch (addressingMode)
+    {
+        case AddressingMode::Implicit:
+        case AddressingMode::Accumulator:
+            return 1;
+        case AddressingMode::Absolute:
+        case AddressingMode::AbsoluteX:
+        case AddressingMode::AbsoluteY:
+        case AddressingMode::Indirect:
+        case AddressingMode::AbsoluteIndexedIndirect:
+        case AddressingMode::ZeroPageRelative:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+constexpr std::string_view Mnemonics[] =
+{
+    "ADC", "AND", "ASL", "BCC", "BCS", "BEQ", "BIT", "BMI",
+    "BNE", "BPL", "BRK", "BVC", "BVS", "CLC", "CLD", "CLI",
+    "CLV", "CMP", "CPX", "CPY", "DEC", "DEX", "DEY", "EOR",
+    "INC", "INX", "INY", "JMP", "JSR", "LDA", "LDX", "LDY",
+    "LSR", "NOP", "ORA", "PHA", "PHP", "PLA", "PLP", "ROL",
+    "ROR", "RTI", "RTS", "SBC", "SEC", "SED", "SEI", "STA",
+    "STX", "STY", "TAX", "TAY", "TSX", "TXA", "TXS", "TYA",
+    "ALR", "ANC", "ANE", "ARR", "DCP", "ISC", "JAM", "LAS",
+    "LAX", "LXA", "RLA", "RRA", "SAX", "SBX", "SHA", "SHX",
+    "SHY", "SLO", "SRE", "TAS", "BBR", "BBS", "BRA", "PHX",
+    "PHY", "PLX", "PLY", "RMB", "SMB", "STP", "STZ", "TRB",
+    "TSB", "WAI",
+};
+
+constexpr auto Mnemonic(Operation operation) -> std::string_view
+{
+    return Mnemonics[static_cast<u8>(operation)];
+}
+
+struct Instruction
+{
+    Operation operation;
+    AddressingMode addressingMode;
+    u8 cycles;
+};
+
+constexpr Instruction Instructions[0x100] =
+{
+    // 0x00
+    { Operation::BRK, AddressingMode::Implicit, 7 },
+    { Operation::ORA, AddressingMode::IndirectX, 6 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::SLO, AddressingMode::IndirectX, 8 },
+    { Operation::NOP, AddressingMode::ZeroPage, 3 },
+    { Operation::ORA, AddressingMode::ZeroPage, 3 },
+    { Operation::ASL, AddressingMode::ZeroPage, 5 },
+    { Operation::SLO, AddressingMode::ZeroPage, 5 },
+    { Operation::PHP, AddressingMode::Implicit, 3 },
+    { Operation::ORA, AddressingMode::Immediate, 2 },
+    { Operation::ASL, AddressingMode::Accumulator, 2 },
+    { Operation::ANC, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Absolute, 4 },
+    { Operation::ORA, AddressingMode::Absolute, 4 },
+    { Operation::ASL, AddressingMode::Absolute, 6 },
+    { Operation::SLO, AddressingMode::Absolute, 6 },
+
+    // 0x10
+    { Operation::BPL, AddressingMode::Relative, 2 },
+    { Operation::ORA, AddressingMode::IndirectY, 5 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::SLO, AddressingMode::IndirectY, 8 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::ORA, AddressingMode::ZeroPageX, 4 },
+    { Operation::ASL, AddressingMode::ZeroPageX, 6 },
+    { Operation::SLO, AddressingMode::ZeroPageX, 6 },
+    { Operation::CLC, AddressingMode::Implicit, 2 },
+    { Operation::ORA, AddressingMode::AbsoluteY, 4 },
+    { Operation::NOP, AddressingMode::Implicit, 2 },
+    { Operation::SLO, AddressingMode::AbsoluteY, 7 },
+    { Operation::NOP, AddressingMode::AbsoluteX, 4 },
+    { Operation::ORA, AddressingMode::AbsoluteX, 4 },
+    { Operation::ASL, AddressingMode::AbsoluteX, 7 },
+    { Operation::SLO, AddressingMode::AbsoluteX, 7 },
+
+    // 0x20
+    { Operation::JSR, AddressingMode::Absolute, 6 },
+    { Operation::AND, AddressingMode::IndirectX, 6 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::RLA, AddressingMode::IndirectX, 8 },
+    { Operation::BIT, AddressingMode::ZeroPage, 3 },
+    { Operation::AND, AddressingMode::ZeroPage, 3 },
+    { Operation::ROL, AddressingMode::ZeroPage, 5 },
+    { Operation::RLA, AddressingMode::ZeroPage, 5 },
+    { Operation::PLP, AddressingMode::Implicit, 4 },
+    { Operation::AND, AddressingMode::Immediate, 2 },
+    { Operation::ROL, AddressingMode::Accumulator, 2 },
+    { Operation::ANC, AddressingMode::Immediate, 2 },
+    { Operation::BIT, AddressingMode::Absolute, 4 },
+    { Operation::AND, AddressingMode::Absolute, 4 },
+    { Operation::ROL, AddressingMode::Absolute, 6 },
+    { Operation::RLA, AddressingMode::Absolute, 6 },
+
+    // 0x30
+    { Operation::BMI, AddressingMode::Relative, 2 },
+    { Operation::AND, AddressingMode::IndirectY, 5 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::RLA, AddressingMode::IndirectY, 8 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::AND, AddressingMode::ZeroPageX, 4 },
+    { Operation::ROL, AddressingMode::ZeroPageX, 6 },
+    { Operation::RLA, AddressingMode::ZeroPageX, 6 },
+    { Operation::SEC, AddressingMode::Implicit, 2 },
+    { Operation::AND, AddressingMode::AbsoluteY, 4 },
+    { Operation::NOP, AddressingMode::Implicit, 2 },
+    { Operation::RLA, AddressingMode::AbsoluteY, 7 },
+    { Operation::NOP, AddressingMode::AbsoluteX, 4 },
+    { Operation::AND, AddressingMode::AbsoluteX, 4 },
+    { Operation::ROL, AddressingMode::AbsoluteX, 7 },
+    { Operation::RLA, AddressingMode::AbsoluteX, 7 },
+
+    // 0x40
+    { Operation::RTI, AddressingMode::Implicit, 6 },
+    { Operation::EOR, AddressingMode::IndirectX, 6 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::SRE, AddressingMode::IndirectX, 8 },
+    { Operation::NOP, AddressingMode::ZeroPage, 3 },
+    { Operation::EOR, AddressingMode::ZeroPage, 3 },
+    { Operation::LSR, AddressingMode::ZeroPage, 5 },
+    { Operation::SRE, AddressingMode::ZeroPage, 5 },
+    { Operation::PHA, AddressingMode::Implicit, 3 },
+    { Operation::EOR, AddressingMode::Immediate, 2 },
+    { Operation::LSR, AddressingMode::Accumulator, 2 },
+    { Operation::ALR, AddressingMode::Immediate, 2 },
+    { Operation::JMP, AddressingMode::Absolute, 3 },
+    { Operation::EOR, AddressingMode::Absolute, 4 },
+    { Operation::LSR, AddressingMode::Absolute, 6 },
+    { Operation::SRE, AddressingMode::Absolute, 6 },
+
+    // 0x50
+    { Operation::BVC, AddressingMode::Relative, 2 },
+    { Operation::EOR, AddressingMode::IndirectY, 5 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::SRE, AddressingMode::IndirectY, 8 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::EOR, AddressingMode::ZeroPageX, 4 },
+    { Operation::LSR, AddressingMode::ZeroPageX, 6 },
+    { Operation::SRE, AddressingMode::ZeroPageX, 6 },
+    { Operation::CLI, AddressingMode::Implicit, 2 },
+    { Operation::EOR, AddressingMode::AbsoluteY, 4 },
+    { Operation::NOP, AddressingMode::Implicit, 2 },
+    { Operation::SRE, AddressingMode::AbsoluteY, 7 },
+    { Operation::NOP, AddressingMode::AbsoluteX, 4 },
+    { Operation::EOR, AddressingMode::AbsoluteX, 4 },
+    { Operation::LSR, AddressingMode::AbsoluteX, 7 },
+    { Operation::SRE, AddressingMode::AbsoluteX, 7 },
+
+    // 0x60
+    { Operation::RTS, AddressingMode::Implicit, 6 },
+    { Operation::ADC, AddressingMode::IndirectX, 6 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::RRA, AddressingMode::IndirectX, 8 },
+    { Operation::NOP, AddressingMode::ZeroPage, 3 },
+    { Operation::ADC, AddressingMode::ZeroPage, 3 },
+    { Operation::ROR, AddressingMode::ZeroPage, 5 },
+    { Operation::RRA, AddressingMode::ZeroPage, 5 },
+    { Operation::PLA, AddressingMode::Implicit, 4 },
+    { Operation::ADC, AddressingMode::Immediate, 2 },
+    { Operation::ROR, AddressingMode::Accumulator, 2 },
+    { Operation::ARR, AddressingMode::Immediate, 2 },
+    { Operation::JMP, AddressingMode::Indirect, 5 },
+    { Operation::ADC, AddressingMode::Absolute, 4 },
+    { Operation::ROR, AddressingMode::Absolute, 6 },
+    { Operation::RRA, AddressingMode::Absolute, 6 },
+
+    // 0x70
+    { Operation::BVS, AddressingMode::Relative, 2 },
+    { Operation::ADC, AddressingMode::IndirectY, 5 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::RRA, AddressingMode::IndirectY, 8 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::ADC, AddressingMode::ZeroPageX, 4 },
+    { Operation::ROR, AddressingMode::ZeroPageX, 6 },
+    { Operation::RRA, AddressingMode::ZeroPageX, 6 },
+    { Operation::SEI, AddressingMode::Implicit, 2 },
+    { Operation::ADC, AddressingMode::AbsoluteY, 4 },
+    { Operation::NOP, AddressingMode::Implicit, 2 },
+    { Operation::RRA, AddressingMode::AbsoluteY, 7 },
+    { Operation::NOP, AddressingMode::AbsoluteX, 4 },
+    { Operation::ADC, AddressingMode::AbsoluteX, 4 },
+    { Operation::ROR, AddressingMode::AbsoluteX, 7 },
+    { Operation::RRA, AddressingMode::AbsoluteX, 7 },
+
+    // 0x80
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::STA, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::SAX, AddressingMode::IndirectX, 6 },
+    { Operation::STY, AddressingMode::ZeroPage, 3 },
+    { Operation::STA, AddressingMode::ZeroPage, 3 },
+    { Operation::STX, AddressingMode::ZeroPage, 3 },
+    { Operation::SAX, AddressingMode::ZeroPage, 3 },
+    { Operation::DEY, AddressingMode::Implicit, 2 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::TXA, AddressingMode::Implicit, 2 },
+    { Operation::ANE, AddressingMode::Immediate, 2 },
+    { Operation::STY, AddressingMode::Absolute, 4 },
+    { Operation::STA, AddressingMode::Absolute, 4 },
+    { Operation::STX, AddressingMode::Absolute, 4 },
+    { Operation::SAX, AddressingMode::Absolute, 4 },
+
+    // 0x90
+    { Operation::BCC, AddressingMode::Relative, 2 },
+    { Operation::STA, AddressingMode::IndirectY, 6 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::SHA, AddressingMode::IndirectY, 6 },
+    { Operation::STY, AddressingMode::ZeroPageX, 4 },
+    { Operation::STA, AddressingMode::ZeroPageX, 4 },
+    { Operation::STX, AddressingMode::ZeroPageY, 4 },
+    { Operation::SAX, AddressingMode::ZeroPageY, 4 },
+    { Operation::TYA, AddressingMode::Implicit, 2 },
+    { Operation::STA, AddressingMode::AbsoluteY, 5 },
+    { Operation::TXS, AddressingMode::Implicit, 2 },
+    { Operation::TAS, AddressingMode::AbsoluteY, 5 },
+    { Operation::SHY, AddressingMode::AbsoluteX, 5 },
+    { Operation::STA, AddressingMode::AbsoluteX, 5 },
+    { Operation::SHX, AddressingMode::AbsoluteY, 5 },
+    { Operation::SHA, AddressingMode::AbsoluteY, 5 },
+
+    // 0xA0
+    { Operation::LDY, AddressingMode::Immediate, 2 },
+    { Operation::LDA, AddressingMode::IndirectX, 6 },
+    { Operation::LDX, AddressingMode::Immediate, 2 },
+    { Operation::LAX, AddressingMode::IndirectX, 6 },
+    { Operation::LDY, AddressingMode::ZeroPage, 3 },
+    { Operation::LDA, AddressingMode::ZeroPage, 3 },
+    { Operation::LDX, AddressingMode::ZeroPage, 3 },
+    { Operation::LAX, AddressingMode::ZeroPage, 3 },
+    { Operation::TAY, AddressingMode::Implicit, 2 },
+    { Operation::LDA, AddressingMode::Immediate, 2 },
+    { Operation::TAX, AddressingMode::Implicit, 2 },
+    { Operation::LXA, AddressingMode::Immediate, 2 },
+    { Operation::LDY, AddressingMode::Absolute, 4 },
+    { Operation::LDA, AddressingMode::Absolute, 4 },
+    { Operation::LDX, AddressingMode::Absolute, 4 },
+    { Operation::LAX, AddressingMode::Absolute, 4 },
+
+    // 0xB0
+    { Operation::BCS, AddressingMode::Relative, 2 },
+    { Operation::LDA, AddressingMode::IndirectY, 5 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::LAX, AddressingMode::IndirectY, 5 },
+    { Operation::LDY, AddressingMode::ZeroPageX, 4 },
+    { Operation::LDA, AddressingMode::ZeroPageX, 4 },
+    { Operation::LDX, AddressingMode::ZeroPageY, 4 },
+    { Operation::LAX, AddressingMode::ZeroPageY, 4 },
+    { Operation::CLV, AddressingMode::Implicit, 2 },
+    { Operation::LDA, AddressingMode::AbsoluteY, 4 },
+    { Operation::TSX, AddressingMode::Implicit, 2 },
+    { Operation::LAS, AddressingMode::AbsoluteY, 4 },
+    { Operation::LDY, AddressingMode::AbsoluteX, 4 },
+    { Operation::LDA, AddressingMode::AbsoluteX, 4 },
+    { Operation::LDX, AddressingMode::AbsoluteY, 4 },
+    { Operation::LAX, AddressingMode::AbsoluteY, 4 },
+
+    // 0xC0
+    { Operation::CPY, AddressingMode::Immediate, 2 },
+    { Operation::CMP, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::DCP, AddressingMode::IndirectX, 8 },
+    { Operation::CPY, AddressingMode::ZeroPage, 3 },
+    { Operation::CMP, AddressingMode::ZeroPage, 3 },
+    { Operation::DEC, AddressingMode::ZeroPage, 5 },
+    { Operation::DCP, AddressingMode::ZeroPage, 5 },
+    { Operation::INY, AddressingMode::Implicit, 2 },
+    { Operation::CMP, AddressingMode::Immediate, 2 },
+    { Operation::DEX, AddressingMode::Implicit, 2 },
+    { Operation::SBX, AddressingMode::Immediate, 2 },
+    { Operation::CPY, AddressingMode::Absolute, 4 },
+    { Operation::CMP, AddressingMode::Absolute, 4 },
+    { Operation::DEC, AddressingMode::Absolute, 6 },
+    { Operation::DCP, AddressingMode::Absolute, 6 },
+
+    // 0xD0
+    { Operation::BNE, AddressingMode::Relative, 2 },
+    { Operation::CMP, AddressingMode::IndirectY, 5 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::DCP, AddressingMode::IndirectY, 8 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::CMP, AddressingMode::ZeroPageX, 4 },
+    { Operation::DEC, AddressingMode::ZeroPageX, 6 },
+    { Operation::DCP, AddressingMode::ZeroPageX, 6 },
+    { Operation::CLD, AddressingMode::Implicit, 2 },
+    { Operation::CMP, AddressingMode::AbsoluteY, 4 },
+    { Operation::NOP, AddressingMode::Implicit, 2 },
+    { Operation::DCP, AddressingMode::AbsoluteY, 7 },
+    { Operation::NOP, AddressingMode::AbsoluteX, 4 },
+    { Operation::CMP, AddressingMode::AbsoluteX, 4 },
+    { Operation::DEC, AddressingMode::AbsoluteX, 7 },
+    { Operation::DCP, AddressingMode::AbsoluteX, 7 },
+
+    // 0xE0
+    { Operation::CPX, AddressingMode::Immediate, 2 },
+    { Operation::SBC, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::ISC, AddressingMode::IndirectX, 8 },
+    { Operation::CPX, AddressingMode::ZeroPage, 3 },
+    { Operation::SBC, AddressingMode::ZeroPage, 3 },
+    { Operation::INC, AddressingMode::ZeroPage, 5 },
+    { Operation::ISC, AddressingMode::ZeroPage, 5 },
+    { Operation::INX, AddressingMode::Implicit, 2 },
+    { Operation::SBC, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 2 },
+    { Operation::SBC, AddressingMode::Immediate, 2 },
+    { Operation::CPX, AddressingMode::Absolute, 4 },
+    { Operation::SBC, AddressingMode::Absolute, 4 },
+    { Operation::INC, AddressingMode::Absolute, 6 },
+    { Operation::ISC, AddressingMode::Absolute, 6 },
+
+    // 0xF0
+    { Operation::BEQ, AddressingMode::Relative, 2 },
+    { Operation::SBC, AddressingMode::IndirectY, 5 },
+    { Operation::JAM, AddressingMode::Implicit, 2 },
+    { Operation::ISC, AddressingMode::IndirectY, 8 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::SBC, AddressingMode::ZeroPageX, 4 },
+    { Operation::INC, AddressingMode::ZeroPageX, 6 },
+    { Operation::ISC, AddressingMode::ZeroPageX, 6 },
+    { Operation::SED, AddressingMode::Implicit, 2 },
+    { Operation::SBC, AddressingMode::AbsoluteY, 4 },
+    { Operation::NOP, AddressingMode::Implicit, 2 },
+    { Operation::ISC, AddressingMode::AbsoluteY, 7 },
+    { Operation::NOP, AddressingMode::AbsoluteX, 4 },
+    { Operation::SBC, AddressingMode::AbsoluteX, 4 },
+    { Operation::INC, AddressingMode::AbsoluteX, 7 },
+    { Operation::ISC, AddressingMode::AbsoluteX, 7 },
+};
+
+constexpr Instruction CmosInstructions[0x100] =
+{
+    // 0x00
+    { Operation::BRK, AddressingMode::Implicit, 7 },
+    { Operation::ORA, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::TSB, AddressingMode::ZeroPage, 5 },
+    { Operation::ORA, AddressingMode::ZeroPage, 3 },
+    { Operation::ASL, AddressingMode::ZeroPage, 5 },
+    { Operation::RMB, AddressingMode::ZeroPage, 5 },
+    { Operation::PHP, AddressingMode::Implicit, 3 },
+    { Operation::ORA, AddressingMode::Immediate, 2 },
+    { Operation::ASL, AddressingMode::Accumulator, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::TSB, AddressingMode::Absolute, 6 },
+    { Operation::ORA, AddressingMode::Absolute, 4 },
+    { Operation::ASL, AddressingMode::Absolute, 6 },
+    { Operation::BBR, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x10
+    { Operation::BPL, AddressingMode::Relative, 2 },
+    { Operation::ORA, AddressingMode::IndirectY, 5 },
+    { Operation::ORA, AddressingMode::ZeroPageIndirect, 5 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::TRB, AddressingMode::ZeroPage, 5 },
+    { Operation::ORA, AddressingMode::ZeroPageX, 4 },
+    { Operation::ASL, AddressingMode::ZeroPageX, 6 },
+    { Operation::RMB, AddressingMode::ZeroPage, 5 },
+    { Operation::CLC, AddressingMode::Implicit, 2 },
+    { Operation::ORA, AddressingMode::AbsoluteY, 4 },
+    { Operation::INC, AddressingMode::Accumulator, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::TRB, AddressingMode::Absolute, 6 },
+    { Operation::ORA, AddressingMode::AbsoluteX, 4 },
+    { Operation::ASL, AddressingMode::AbsoluteX, 6 },
+    { Operation::BBR, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x20
+    { Operation::JSR, AddressingMode::Absolute, 6 },
+    { Operation::AND, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::BIT, AddressingMode::ZeroPage, 3 },
+    { Operation::AND, AddressingMode::ZeroPage, 3 },
+    { Operation::ROL, AddressingMode::ZeroPage, 5 },
+    { Operation::RMB, AddressingMode::ZeroPage, 5 },
+    { Operation::PLP, AddressingMode::Implicit, 4 },
+    { Operation::AND, AddressingMode::Immediate, 2 },
+    { Operation::ROL, AddressingMode::Accumulator, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::BIT, AddressingMode::Absolute, 4 },
+    { Operation::AND, AddressingMode::Absolute, 4 },
+    { Operation::ROL, AddressingMode::Absolute, 6 },
+    { Operation::BBR, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x30
+    { Operation::BMI, AddressingMode::Relative, 2 },
+    { Operation::AND, AddressingMode::IndirectY, 5 },
+    { Operation::AND, AddressingMode::ZeroPageIndirect, 5 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::BIT, AddressingMode::ZeroPageX, 4 },
+    { Operation::AND, AddressingMode::ZeroPageX, 4 },
+    { Operation::ROL, AddressingMode::ZeroPageX, 6 },
+    { Operation::RMB, AddressingMode::ZeroPage, 5 },
+    { Operation::SEC, AddressingMode::Implicit, 2 },
+    { Operation::AND, AddressingMode::AbsoluteY, 4 },
+    { Operation::DEC, AddressingMode::Accumulator, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::BIT, AddressingMode::AbsoluteX, 4 },
+    { Operation::AND, AddressingMode::AbsoluteX, 4 },
+    { Operation::ROL, AddressingMode::AbsoluteX, 6 },
+    { Operation::BBR, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x40
+    { Operation::RTI, AddressingMode::Implicit, 6 },
+    { Operation::EOR, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::NOP, AddressingMode::ZeroPage, 3 },
+    { Operation::EOR, AddressingMode::ZeroPage, 3 },
+    { Operation::LSR, AddressingMode::ZeroPage, 5 },
+    { Operation::RMB, AddressingMode::ZeroPage, 5 },
+    { Operation::PHA, AddressingMode::Implicit, 3 },
+    { Operation::EOR, AddressingMode::Immediate, 2 },
+    { Operation::LSR, AddressingMode::Accumulator, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::JMP, AddressingMode::Absolute, 3 },
+    { Operation::EOR, AddressingMode::Absolute, 4 },
+    { Operation::LSR, AddressingMode::Absolute, 6 },
+    { Operation::BBR, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x50
+    { Operation::BVC, AddressingMode::Relative, 2 },
+    { Operation::EOR, AddressingMode::IndirectY, 5 },
+    { Operation::EOR, AddressingMode::ZeroPageIndirect, 5 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::EOR, AddressingMode::ZeroPageX, 4 },
+    { Operation::LSR, AddressingMode::ZeroPageX, 6 },
+    { Operation::RMB, AddressingMode::ZeroPage, 5 },
+    { Operation::CLI, AddressingMode::Implicit, 2 },
+    { Operation::EOR, AddressingMode::AbsoluteY, 4 },
+    { Operation::PHY, AddressingMode::Implicit, 3 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::NOP, AddressingMode::Absolute, 8 },
+    { Operation::EOR, AddressingMode::AbsoluteX, 4 },
+    { Operation::LSR, AddressingMode::AbsoluteX, 6 },
+    { Operation::BBR, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x60
+    { Operation::RTS, AddressingMode::Implicit, 6 },
+    { Operation::ADC, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::STZ, AddressingMode::ZeroPage, 3 },
+    { Operation::ADC, AddressingMode::ZeroPage, 3 },
+    { Operation::ROR, AddressingMode::ZeroPage, 5 },
+    { Operation::RMB, AddressingMode::ZeroPage, 5 },
+    { Operation::PLA, AddressingMode::Implicit, 4 },
+    { Operation::ADC, AddressingMode::Immediate, 2 },
+    { Operation::ROR, AddressingMode::Accumulator, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::JMP, AddressingMode::Indirect, 6 },
+    { Operation::ADC, AddressingMode::Absolute, 4 },
+    { Operation::ROR, AddressingMode::Absolute, 6 },
+    { Operation::BBR, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x70
+    { Operation::BVS, AddressingMode::Relative, 2 },
+    { Operation::ADC, AddressingMode::IndirectY, 5 },
+    { Operation::ADC, AddressingMode::ZeroPageIndirect, 5 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::STZ, AddressingMode::ZeroPageX, 4 },
+    { Operation::ADC, AddressingMode::ZeroPageX, 4 },
+    { Operation::ROR, AddressingMode::ZeroPageX, 6 },
+    { Operation::RMB, AddressingMode::ZeroPage, 5 },
+    { Operation::SEI, AddressingMode::Implicit, 2 },
+    { Operation::ADC, AddressingMode::AbsoluteY, 4 },
+    { Operation::PLY, AddressingMode::Implicit, 4 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::JMP, AddressingMode::AbsoluteIndexedIndirect, 6 },
+    { Operation::ADC, AddressingMode::AbsoluteX, 4 },
+    { Operation::ROR, AddressingMode::AbsoluteX, 6 },
+    { Operation::BBR, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x80
+    { Operation::BRA, AddressingMode::Relative, 2 },
+    { Operation::STA, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::STY, AddressingMode::ZeroPage, 3 },
+    { Operation::STA, AddressingMode::ZeroPage, 3 },
+    { Operation::STX, AddressingMode::ZeroPage, 3 },
+    { Operation::SMB, AddressingMode::ZeroPage, 5 },
+    { Operation::DEY, AddressingMode::Implicit, 2 },
+    { Operation::BIT, AddressingMode::Immediate, 2 },
+    { Operation::TXA, AddressingMode::Implicit, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::STY, AddressingMode::Absolute, 4 },
+    { Operation::STA, AddressingMode::Absolute, 4 },
+    { Operation::STX, AddressingMode::Absolute, 4 },
+    { Operation::BBS, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0x90
+    { Operation::BCC, AddressingMode::Relative, 2 },
+    { Operation::STA, AddressingMode::IndirectY, 6 },
+    { Operation::STA, AddressingMode::ZeroPageIndirect, 5 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::STY, AddressingMode::ZeroPageX, 4 },
+    { Operation::STA, AddressingMode::ZeroPageX, 4 },
+    { Operation::STX, AddressingMode::ZeroPageY, 4 },
+    { Operation::SMB, AddressingMode::ZeroPage, 5 },
+    { Operation::TYA, AddressingMode::Implicit, 2 },
+    { Operation::STA, AddressingMode::AbsoluteY, 5 },
+    { Operation::TXS, AddressingMode::Implicit, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::STZ, AddressingMode::Absolute, 4 },
+    { Operation::STA, AddressingMode::AbsoluteX, 5 },
+    { Operation::STZ, AddressingMode::AbsoluteX, 5 },
+    { Operation::BBS, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0xA0
+    { Operation::LDY, AddressingMode::Immediate, 2 },
+    { Operation::LDA, AddressingMode::IndirectX, 6 },
+    { Operation::LDX, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::LDY, AddressingMode::ZeroPage, 3 },
+    { Operation::LDA, AddressingMode::ZeroPage, 3 },
+    { Operation::LDX, AddressingMode::ZeroPage, 3 },
+    { Operation::SMB, AddressingMode::ZeroPage, 5 },
+    { Operation::TAY, AddressingMode::Implicit, 2 },
+    { Operation::LDA, AddressingMode::Immediate, 2 },
+    { Operation::TAX, AddressingMode::Implicit, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::LDY, AddressingMode::Absolute, 4 },
+    { Operation::LDA, AddressingMode::Absolute, 4 },
+    { Operation::LDX, AddressingMode::Absolute, 4 },
+    { Operation::BBS, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0xB0
+    { Operation::BCS, AddressingMode::Relative, 2 },
+    { Operation::LDA, AddressingMode::IndirectY, 5 },
+    { Operation::LDA, AddressingMode::ZeroPageIndirect, 5 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::LDY, AddressingMode::ZeroPageX, 4 },
+    { Operation::LDA, AddressingMode::ZeroPageX, 4 },
+    { Operation::LDX, AddressingMode::ZeroPageY, 4 },
+    { Operation::SMB, AddressingMode::ZeroPage, 5 },
+    { Operation::CLV, AddressingMode::Implicit, 2 },
+    { Operation::LDA, AddressingMode::AbsoluteY, 4 },
+    { Operation::TSX, AddressingMode::Implicit, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::LDY, AddressingMode::AbsoluteX, 4 },
+    { Operation::LDA, AddressingMode::AbsoluteX, 4 },
+    { Operation::LDX, AddressingMode::AbsoluteY, 4 },
+    { Operation::BBS, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0xC0
+    { Operation::CPY, AddressingMode::Immediate, 2 },
+    { Operation::CMP, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::CPY, AddressingMode::ZeroPage, 3 },
+    { Operation::CMP, AddressingMode::ZeroPage, 3 },
+    { Operation::DEC, AddressingMode::ZeroPage, 5 },
+    { Operation::SMB, AddressingMode::ZeroPage, 5 },
+    { Operation::INY, AddressingMode::Implicit, 2 },
+    { Operation::CMP, AddressingMode::Immediate, 2 },
+    { Operation::DEX, AddressingMode::Implicit, 2 },
+    { Operation::WAI, AddressingMode::Implicit, 3 },
+    { Operation::CPY, AddressingMode::Absolute, 4 },
+    { Operation::CMP, AddressingMode::Absolute, 4 },
+    { Operation::DEC, AddressingMode::Absolute, 6 },
+    { Operation::BBS, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0xD0
+    { Operation::BNE, AddressingMode::Relative, 2 },
+    { Operation::CMP, AddressingMode::IndirectY, 5 },
+    { Operation::CMP, AddressingMode::ZeroPageIndirect, 5 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::CMP, AddressingMode::ZeroPageX, 4 },
+    { Operation::DEC, AddressingMode::ZeroPageX, 6 },
+    { Operation::SMB, AddressingMode::ZeroPage, 5 },
+    { Operation::CLD, AddressingMode::Implicit, 2 },
+    { Operation::CMP, AddressingMode::AbsoluteY, 4 },
+    { Operation::PHX, AddressingMode::Implicit, 3 },
+    { Operation::STP, AddressingMode::Implicit, 3 },
+    { Operation::NOP, AddressingMode::Absolute, 4 },
+    { Operation::CMP, AddressingMode::AbsoluteX, 4 },
+    { Operation::DEC, AddressingMode::AbsoluteX, 7 },
+    { Operation::BBS, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0xE0
+    { Operation::CPX, AddressingMode::Immediate, 2 },
+    { Operation::SBC, AddressingMode::IndirectX, 6 },
+    { Operation::NOP, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::CPX, AddressingMode::ZeroPage, 3 },
+    { Operation::SBC, AddressingMode::ZeroPage, 3 },
+    { Operation::INC, AddressingMode::ZeroPage, 5 },
+    { Operation::SMB, AddressingMode::ZeroPage, 5 },
+    { Operation::INX, AddressingMode::Implicit, 2 },
+    { Operation::SBC, AddressingMode::Immediate, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 2 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::CPX, AddressingMode::Absolute, 4 },
+    { Operation::SBC, AddressingMode::Absolute, 4 },
+    { Operation::INC, AddressingMode::Absolute, 6 },
+    { Operation::BBS, AddressingMode::ZeroPageRelative, 5 },
+
+    // 0xF0
+    { Operation::BEQ, AddressingMode::Relative, 2 },
+    { Operation::SBC, AddressingMode::IndirectY, 5 },
+    { Operation::SBC, AddressingMode::ZeroPageIndirect, 5 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::NOP, AddressingMode::ZeroPageX, 4 },
+    { Operation::SBC, AddressingMode::ZeroPageX, 4 },
+    { Operation::INC, AddressingMode::ZeroPageX, 6 },
+    { Operation::SMB, AddressingMode::ZeroPage, 5 },
+    { Operation::SED, AddressingMode::Implicit, 2 },
+    { Operation::SBC, AddressingMode::AbsoluteY, 4 },
+    { Operation::PLX, AddressingMode::Implicit, 4 },
+    { Operation::NOP, AddressingMode::Implicit, 1 },
+    { Operation::NOP, AddressingMode::Absolute, 4 },
+    { Operation::SBC, AddressingMode::AbsoluteX, 4 },
+    { Operation::INC, AddressingMode::AbsoluteX, 7 },
+    { Operation::BBS, AddressingMode::ZeroPageRelative, 5 },
+};
+
+constexpr auto Undocumented(u8 opcode) -> bool
+{
+    Operation operation = Instructions[opcode].operation;
+    return operation >= Operation::ALR || (operation == Operation::NOP && opcode != 0xEA) || opcode == 0xEB;
+}
+
+constexpr auto StrictInstructions = []
+{
+    std::array<Instruction, 0x100> table = {};
+    for (u32 opcode = 0; opcode < table.size(); opcode++)
+    {
+        table[opcode] = Undocumented(opcode) ? Instruction{ Operation::JAM, AddressingMode::Implicit, 0 } : Instructions[opcode];
+    }
+    return table;
+}();
+
+template <Variant variant>
+constexpr const Instruction* InstructionSet = variant == Variant::Cmos ? CmosInstructions : variant == Variant::Strict ? StrictInstructions.data() : Instructions;
+
+constexpr auto GetInstructions(Variant variant) -> const Instruction*
+{
+    switch (variant)
+    {
+        case Variant::Cmos:
+            return InstructionSet<Variant::Cmos>;
+        case Variant::Strict:
+            return InstructionSet<Variant::Strict>;
+        default:
+            return InstructionSet<Variant::Nmos>;
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "core.hh"
+#include "opcodes.hh"
+
+class Profiler
+{
+  public:
+    static constexpr u32 AddressCount = 0x10000;
+    static constexpr u32 MaxDepth = 128;
+
+    struct Subroutine
+    {
+        u16 address;
+        u64 calls;
+        u64 inclusiveCycles;
+        u64 selfCycles;
+    };
+
+    Profiler();
+    ~Profiler() = default;
+
+    auto Reset() -> void;
+
+    auto GetExecutions(u16 address) const -> u64
+    {
+        return _executions[address];
+    }
+
+    auto GetCycles(u16 address) const -> u64
+    {
+        return _cycles[address];
+    }
+
+    auto GetReads(u16 address) const -> u64
+    {
+        return _reads[address];
+    }
+
+    auto GetWrites(u16 address) const -> u64
+    {
+        return _writes[address];
+    }
+
+    auto GetOpcodeCount(u8 opcode) const -> u64
+    {
+        return _opcodes[opcode];
+    }
+
+    auto GetVariant() const -> Variant
+    {
+        return _variant;
+    }
+
+    auto GetSubroutines() const -> std::vector<Subroutine>;
+
+    auto WriteFlatProfile(std::ostream& stream, u32 limit = 20) const -> void;
+    auto WriteCollapsedStacks(std::ostream& stream) const -> void;
+
+  private:
+    struct Node
+    {
+        u32 parent;
+        u16 address;
+        u64 cycles;
+    };
+
+    struct Frame
+    {
+        u32 node;
+        u16 address;
+        u8 stack;
+        u64 start;
+    };
+
+    struct Calls
+    {
+        u64 count;
+        u64 cycles;
+        u32 depth;
+    };
+
+    std::vector<u64> _executions;
+    std::vector<u64> _cycles;
+    std::vector<u64> _reads;
+    std::vector<u64> _writes;
+    std::array<u64, 0x100> _opcodes;
+    std::array<u64, 0x100> _opcodeCycles;
+
+    std::vector<Node> _nodes;
+    std::unordered_map<u64, u32> _children;
+    std::vector<Frame> _frames;
+    std::vector<Calls> _calls;
+    u32 _node;
+    Variant _variant;
+
+    friend class CPU;
+
+    auto Read(u16 address) -> void
+    {
+        _reads[address]++;
+    }
+
+    auto Write(u16 address) -> void
+    {
+        _writes[address]++;
+    }
+
+    auto Execute(u16 address, u8 opcode, u64 cycles) -> void
+    {
+        _executions[address]++;
+        _cycles[address] += cycles;
+        _opcodes[opcode]++;
+        _opcodeCycles[opcode] += cycles;
+        _nodes[_node].cycles += cycles;
+    }
+
+    auto Call(u16 address, u8 stack, u64 cycle) -> void;
+    auto Return(u8 stack, u64 cycle) -> void;
+    auto Path(u32 node) const -> std::string;
+};
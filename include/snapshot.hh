@@ -0,0 +1,38 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include "core.hh"
+#include "cpu.hh"
+#include "memory.hh"
+
+class Snapshot
+{
+  public:
+    Snapshot() = default;
+    ~Snapshot() = default;
+
+    static auto Capture(const CPU& cpu, Memory& memory) -> Snapshot;
+    auto Restore(CPU& cpu, Memory& memory) const -> void;
+
+    auto Serialize(const Snapshot* base = nullptr) const -> std::vector<u8>;
+    static auto Deserialize(std::span<const u8> data, const Snapshot* base = nullptr) -> Snapshot;
+
+    auto GetRegisters() const -> Registers;
+    auto GetCycles() const -> u64;
+    auto GetPage(u8 page) const -> const Memory::Page*;
+
+  private:
+    static constexpr u8 Magic[4] = { '6', '5', '0', '2' };
+    static constexpr u8 Version = 1;
+
+    enum class Kind : u8
+    {
+        Full,
+        Incremental,
+    };
+
+    Registers _registers = {};
+    u64 _cycles = 0;
+    Memory::Pages _pages;
+};
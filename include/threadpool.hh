@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core.hh"
+
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(u32 threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+    auto Submit(std::function<void()> task) -> void;
+    auto Wait() -> void;
+    auto GetThreadCount() const -> u32;
+
+  private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _idle;
+    std::atomic<u64> _queued;
+    std::atomic<u64> _pending;
+    std::atomic<u32> _next;
+    bool _stopping;
+
+    auto Loop(u32 index) -> void;
+    auto Pop(u32 index, std::function<void()>& task) -> bool;
+};
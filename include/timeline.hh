@@ -0,0 +1,55 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+#include "breakpoints.hh"
+#include "core.hh"
+#include "cpu.hh"
+#include "memory.hh"
+#include "snapshot.hh"
+
+class Timeline
+{
+  public:
+    static constexpr u64 DefaultInterval = 0x100000;
+
+    Timeline(CPU& cpu, Memory& memory, Variant variant = Variant::Nmos, u64 interval = DefaultInterval);
+    ~Timeline() = default;
+
+    Timeline(const Timeline&) = delete;
+    auto operator=(const Timeline&) -> Timeline& = delete;
+
+    auto Run(u64 instructions, u64 cycles) -> RunResult;
+    auto Run(u64 instructions, u64 cycles, Breakpoints& breakpoints) -> RunResult;
+    auto Commit() -> void;
+    auto Seek(u64 position) -> void;
+    auto ReverseStep(u64 count = 1) -> bool;
+    auto ReverseContinue(Breakpoints& breakpoints) -> bool;
+    auto LastWrite(u16 address) -> std::optional<u64>;
+
+    auto GetPosition() const -> u64;
+    auto GetEnd() const -> u64;
+    auto GetCheckpointCount() const -> u64;
+
+  private:
+    struct Checkpoint
+    {
+        u64 position;
+        Snapshot snapshot;
+    };
+
+    CPU& _cpu;
+    Memory& _memory;
+    Variant _variant;
+    u64 _interval;
+    std::vector<Checkpoint> _checkpoints;
+    u64 _position;
+    u64 _end;
+
+    auto Record(u64 instructions, u64 cycles, Breakpoints* breakpoints) -> RunResult;
+    auto Advance(u64 instructions, u64 cycles, Breakpoints* breakpoints) -> RunResult;
+    auto Restore(u64 index) -> void;
+    auto Find(u64 position) const -> u64;
+    auto Search(Breakpoints& breakpoints, u64 before, std::optional<u8> page) -> std::optional<u64>;
+    auto Scan(u64 index, u64 end, Breakpoints& breakpoints) -> std::optional<u64>;
+};
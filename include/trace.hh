@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include "core.hh"
+#include "opcodes.hh"
+
+struct TraceRecord
+{
+    u64 cycles : 48;
+    u64 PC : 16;
+    u16 operand;
+    u8 opcode;
+    u8 A;
+    u8 X;
+    u8 Y;
+    u8 SP;
+    u8 PS;
+};
+
+static_assert(sizeof(TraceRecord) == 16);
+
+class Trace
+{
+  public:
+    static constexpr char Magic[8] = { '6', '5', '0', '2', 'T', 'R', 'C', 0x02 };
+
+    explicit Trace(u64 capacity = 0x10000);
+    ~Trace();
+
+    Trace(const Trace&) = delete;
+    auto operator=(const Trace&) -> Trace& = delete;
+
+    auto Open(const std::filesystem::path& path) -> void;
+    auto Close() -> void;
+    auto Flush() -> void;
+    auto Clear() -> void;
+
+    auto GetCapacity() const -> u64;
+    auto GetCount() const -> u64;
+    auto GetLast(u64 count) const -> std::vector<TraceRecord>;
+    auto GetVariant() const -> Variant;
+
+    static auto Load(const std::filesystem::path& path) -> std::vector<TraceRecord>;
+    static auto Load(const std::filesystem::path& path, Variant& variant) -> std::vector<TraceRecord>;
+
+  private:
+    std::unique_ptr<TraceRecord[]> _records;
+    u64 _mask;
+    std::atomic<u64> _head;
+    u64 _flushed;
+    std::FILE* _file;
+    bool _header;
+    Variant _variant;
+
+    friend class CPU;
+
+    auto Record(const TraceRecord& record) -> void
+    {
+        u64 head = _head.load(std::memory_order_relaxed);
+        _records[head & _mask] = record;
+        _head.store(head + 1, std::memory_order_release);
+        if (_file != nullptr && ((head + 1) & _mask) == 0) [[unlikely]]
+        {
+            Flush();
+        }
+    }
+};
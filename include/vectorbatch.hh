@@ -0,0 +1,29 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include "batch.hh"
+#include "core.hh"
+#include "threadpool.hh"
+
+class VectorBatch
+{
+  public:
+    static constexpr u32 MaxLanes = 32;
+
+    explicit VectorBatch(u32 lanes = 16, u32 threads = std::thread::hardware_concurrency());
+    ~VectorBatch() = default;
+
+    auto Run(const std::vector<Job>& jobs) -> std::vector<JobResult>;
+    auto GetLaneCount() const -> u32;
+    auto GetThreadCount() const -> u32;
+
+    static auto Execute(std::span<const Job> jobs, std::span<JobResult> results) -> void;
+
+  private:
+    template <u32 lanes>
+    class Group;
+
+    ThreadPool _pool;
+    u32 _lanes;
+};
@@ -0,0 +1,64 @@
+#include <batch.hh>
+#include <algorithm>
+
+Batch::Batch(u32 threads) : _pool(threads)
+{
+}
+
+auto Batch::Run(const std::vector<Job>& jobs) -> std::vector<JobResult>
+{
+    std::vector<JobResult> results(jobs.size());
+
+    u64 chunk = std::max<u64>(1, jobs.size() / (_pool.GetThreadCount() * 16));
+    for (u64 first = 0; first < jobs.size(); first += chunk)
+    {
+        u64 last = std::min<u64>(first + chunk, jobs.size());
+        _pool.Submit([&jobs, &results, first, last]
+        {
+            for (u64 index = first; index < last; index++)
+            {
+                results[index] = Execute(jobs[index]);
+            }
+        });
+    }
+
+    _pool.Wait();
+    return results;
+}
+
+auto Batch::GetThreadCount() const -> u32
+{
+    return _pool.GetThreadCount();
+}
+
+auto Batch::Execute(const Job& job) -> JobResult
+{
+    CPU cpu;
+    Memory memory;
+
+    memory.Map(*job.image);
+
+    Registers registers = cpu.GetRegisters();
+    registers.PC = job.entry;
+    cpu.SetRegisters(registers);
+
+    JobResult result;
+    result.run = cpu.RunCycles(memory, job.cycles);
+    result.registers = cpu.GetRegisters();
+    result.digest = Digest(memory);
+    return result;
+}
+
+auto Batch::Digest(const Memory& memory) -> u64
+{
+    u64 digest = 0xCBF29CE484222325;
+    for (u32 page = 0; page < Memory::PageCount; page++)
+    {
+        for (u8 data : std::span(memory.GetPage(page), Memory::PageSize))
+        {
+            digest ^= data;
+            digest *= 0x100000001B3;
+        }
+    }
+    return digest;
+}
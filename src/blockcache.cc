@@ -0,0 +1,432 @@
+#include <blockcache.hh>
+#include <jit.hh>
+#include <limits>
+
+BlockCache::BlockCache(Variant variant) : _variant(variant), _instructions(GetInstructions(variant)), _handlers(CPU::Handlers(variant)), _decodedHandlers(CPU::DecodedHandlers(variant))
+{
+}
+
+BlockCache::~BlockCache() = default;
+
+auto BlockCache::Run(CPU& cpu, Memory& memory) -> void
+{
+    RunFor(cpu, memory, std::numeric_limits<u64>::max(), std::numeric_limits<u64>::max());
+}
+
+auto BlockCache::Step(CPU& cpu, Memory& memory) -> RunResult
+{
+    return RunFor(cpu, memory, 1, std::numeric_limits<u64>::max());
+}
+
+auto BlockCache::RunInstructions(CPU& cpu, Memory& memory, u64 instructions) -> RunResult
+{
+    return RunFor(cpu, memory, instructions, std::numeric_limits<u64>::max());
+}
+
+auto BlockCache::RunCycles(CPU& cpu, Memory& memory, u64 cycles) -> RunResult
+{
+    return RunFor(cpu, memory, std::numeric_limits<u64>::max(), cycles);
+}
+
+auto BlockCache::RunFor(CPU& cpu, Memory& memory, u64 instructions, u64 cycles) -> RunResult
+{
+    if (memory.GetId() != _memory)
+    {
+        Flush();
+        _memory = memory.GetId();
+    }
+
+    RunResult result = { StopReason::Break, 0, 0 };
+    u64 start = cpu._cycles;
+    cpu.Bind(memory);
+
+    Block* block = nullptr;
+    while (cpu.BF == 0)
+    {
+        if (result.instructions == instructions)
+        {
+            result.reason = StopReason::InstructionLimit;
+            break;
+        }
+
+        if (cpu._cycles - start >= cycles)
+        {
+            result.reason = StopReason::CycleLimit;
+            break;
+        }
+
+        if (cpu._cycles >= *cpu._deadline) [[unlikely]]
+        {
+            cpu.Poll(memory, _variant);
+            block = nullptr;
+        }
+
+        block = Follow(memory, block, cpu.PC);
+        if (block == nullptr)
+        {
+            _handlers[memory.Read(cpu.PC++)](cpu, memory);
+            result.instructions++;
+            continue;
+        }
+
+        if (_jit != nullptr && block->code == nullptr && ++block->entries == Jit::Threshold)
+        {
+            Compile(*block);
+        }
+
+        u32 generation = memory.GetCodeGeneration();
+        u64 count = block->records.size();
+        bool bounded = instructions - result.instructions < count || cycles - (cpu._cycles - start) <= block->maxCycles || cpu._cycles + block->maxCycles >= *cpu._deadline;
+        if (!bounded && block->code != nullptr)
+        {
+            result.instructions += block->code(&cpu, &memory, &memory.GetCodeGeneration());
+            continue;
+        }
+
+        const Record* records = block->records.data();
+        if (!bounded)
+        {
+            for (u64 index = 0; index < count; index++)
+            {
+                const Record& record = records[index];
+                cpu.PC += record.length;
+                record.handler(cpu, memory, record.operand);
+
+                if (record.accesses && ((record.writes && memory.GetCodeGeneration() != generation) || cpu._cycles >= *cpu._deadline)) [[unlikely]]
+                {
+                    count = index + 1;
+                    break;
+                }
+            }
+            result.instructions += count;
+            continue;
+        }
+
+        for (u64 index = 0; index < count; index++)
+        {
+            if (result.instructions + index == instructions || cpu._cycles - start >= cycles)
+            {
+                count = index;
+                break;
+            }
+
+            const Record& record = records[index];
+            cpu.PC += record.length;
+            record.handler(cpu, memory, record.operand);
+
+            if ((record.writes && memory.GetCodeGeneration() != generation) || cpu._cycles >= *cpu._deadline)
+            {
+                count = index + 1;
+                break;
+            }
+        }
+        result.instructions += count;
+    }
+
+    if (cpu.BF != 0)
+    {
+        result.reason = cpu.GetStopReason();
+    }
+
+    result.cycles = cpu._cycles - start;
+    return result;
+}
+
+auto BlockCache::Flush() -> void
+{
+    for (std::unique_ptr<Page>& page : _blocks)
+    {
+        page.reset();
+    }
+    _count = 0;
+    _compiled = 0;
+    _memory = 0;
+    if (_jit != nullptr)
+    {
+        _jit->Reset();
+    }
+}
+
+auto BlockCache::GetBlockCount() const -> u64
+{
+    return _count;
+}
+
+auto BlockCache::SetJitEnabled(bool enabled) -> void
+{
+    Flush();
+    _jit.reset();
+    if (enabled && Jit::IsSupported())
+    {
+        _jit = std::make_unique<Jit>();
+        if (!_jit->IsAvailable())
+        {
+            _jit.reset();
+        }
+    }
+}
+
+auto BlockCache::IsJitEnabled() const -> bool
+{
+    return _jit != nullptr;
+}
+
+auto BlockCache::GetCompiledBlockCount() const -> u64
+{
+    return _compiled;
+}
+
+auto BlockCache::GetVariant() const -> Variant
+{
+    return _variant;
+}
+
+auto BlockCache::Lookup(Memory& memory, u16 address) -> Block*
+{
+    std::unique_ptr<Page>& page = _blocks[address >> 8];
+    if (page == nullptr)
+    {
+        page = std::make_unique<Page>();
+    }
+
+    std::unique_ptr<Block>& slot = (*page)[address & 0xFF];
+    if (slot != nullptr)
+    {
+        if (slot->generation == memory.GetCodeGeneration())
+        {
+            return slot.get();
+        }
+
+        if (memory.GetCodeVersion(slot->first) == slot->versions[0] && memory.GetCodeVersion(slot->last) == slot->versions[1])
+        {
+            slot->generation = memory.GetCodeGeneration();
+            return slot.get();
+        }
+
+        _compiled -= slot->code != nullptr;
+        slot.reset();
+        _count--;
+    }
+
+    slot = Translate(memory, address);
+    _count += slot != nullptr;
+    return slot.get();
+}
+
+auto BlockCache::Follow(Memory& memory, Block* previous, u16 address) -> Block*
+{
+    u32 generation = memory.GetCodeGeneration();
+    if (previous == nullptr || previous->generation != generation)
+    {
+        return Lookup(memory, address);
+    }
+
+    Link& link = previous->links[address != previous->end];
+    if (link.address == address && link.generation == generation && link.block != nullptr)
+    {
+        return link.block;
+    }
+
+    Block* block = Lookup(memory, address);
+    link = { block, generation, address };
+    return block;
+}
+
+auto BlockCache::Compile(Block& block) -> void
+{
+    block.code = _jit->Compile(block.address, block.records, _instructions);
+    if (block.code != nullptr)
+    {
+        _compiled++;
+        return;
+    }
+
+    if (_jit->IsAvailable() && !_jit->IsFull())
+    {
+        return;
+    }
+
+    for (std::unique_ptr<Page>& page : _blocks)
+    {
+        if (page == nullptr)
+        {
+            continue;
+        }
+
+        for (std::unique_ptr<Block>& slot : *page)
+        {
+            if (slot != nullptr)
+            {
+                slot->code = nullptr;
+                slot->entries = 0;
+            }
+        }
+    }
+    _compiled = 0;
+    if (_jit->IsAvailable())
+    {
+        _jit->Reset();
+    }
+    else
+    {
+        _jit.reset();
+    }
+}
+
+auto BlockCache::Translate(Memory& memory, u16 address) -> std::unique_ptr<Block>
+{
+    auto block = std::make_unique<Block>();
+    block->code = nullptr;
+    block->entries = 0;
+    block->maxCycles = 0;
+    block->address = address;
+
+    u32 pc = address;
+    while (block->records.size() < MaxBlockLength && pc >= Memory::DirectPageCount * Memory::PageSize && !memory.IsDevice(pc >> 8))
+    {
+        u8 opcode = memory.Read(pc);
+        const Instruction& instruction = _instructions[opcode];
+        u8 length = Length(instruction.addressingMode);
+        if (pc + length > 0x10000 || memory.IsDevice((pc + length - 1) >> 8))
+        {
+            break;
+        }
+
+        u16 operand = 0;
+        if (length > 1)
+        {
+            operand = memory.Read(pc + 1);
+        }
+        if (length > 2)
+        {
+            operand |= memory.Read(pc + 2) << 8;
+        }
+
+        block->records.push_back({ _decodedHandlers[opcode], operand, opcode, length, instruction.cycles, Writes(instruction), Accesses(instruction) });
+        block->maxCycles += instruction.cycles + 2;
+        pc += length;
+
+        if (EndsBlock(instruction.operation))
+        {
+            break;
+        }
+    }
+
+    if (block->records.empty())
+    {
+        return nullptr;
+    }
+
+    memory.MarkCode(address, pc - 1);
+    block->end = pc;
+    block->links[0] = { nullptr, 0, 0 };
+    block->links[1] = { nullptr, 0, 0 };
+    block->first = address >> 8;
+    block->last = (pc - 1) >> 8;
+    block->versions[0] = memory.GetCodeVersion(block->first);
+    block->versions[1] = memory.GetCodeVersion(block->last);
+    block->generation = memory.GetCodeGeneration();
+    return block;
+}
+
+auto BlockCache::Writes(Instruction instruction) -> bool
+{
+    switch (instruction.operation)
+    {
+        case Operation::ASL:
+        case Operation::LSR:
+        case Operation::ROL:
+        case Operation::ROR:
+        case Operation::DEC:
+        case Operation::INC:
+            return instruction.addressingMode != AddressingMode::Accumulator;
+        case Operation::DCP:
+        case Operation::ISC:
+        case Operation::PHA:
+        case Operation::PHP:
+        case Operation::PHX:
+        case Operation::PHY:
+        case Operation::RLA:
+        case Operation::RMB:
+        case Operation::RRA:
+        case Operation::SAX:
+        case Operation::SHA:
+        case Operation::SHX:
+        case Operation::SHY:
+        case Operation::SLO:
+        case Operation::SMB:
+        case Operation::SRE:
+        case Operation::STA:
+        case Operation::STX:
+        case Operation::STY:
+        case Operation::STZ:
+        case Operation::TAS:
+        case Operation::TRB:
+        case Operation::TSB:
+            return true;
+        default:
+            return false;
+    }
+}
+
+auto BlockCache::Accesses(Instruction instruction) -> bool
+{
+    switch (instruction.addressingMode)
+    {
+        case AddressingMode::Accumulator:
+        case AddressingMode::Immediate:
+        case AddressingMode::Relative:
+            return false;
+        case AddressingMode::Implicit:
+            switch (instruction.operation)
+            {
+                case Operation::BRK:
+                case Operation::PHA:
+                case Operation::PHP:
+                case Operation::PHX:
+                case Operation::PHY:
+                case Operation::PLA:
+                case Operation::PLP:
+                case Operation::PLX:
+                case Operation::PLY:
+                case Operation::RTI:
+                case Operation::RTS:
+                    return true;
+                default:
+                    return false;
+            }
+        default:
+            return true;
+    }
+}
+
+auto BlockCache::EndsBlock(Operation operation) -> bool
+{
+    switch (operation)
+    {
+        case Operation::BBR:
+        case Operation::BBS:
+        case Operation::BCC:
+        case Operation::BCS:
+        case Operation::BEQ:
+        case Operation::BMI:
+        case Operation::BNE:
+        case Operation::BPL:
+        case Operation::BRA:
+        case Operation::BRK:
+        case Operation::BVC:
+        case Operation::BVS:
+        case Operation::CLI:
+        case Operation::JAM:
+        case Operation::JMP:
+        case Operation::JSR:
+        case Operation::PLP:
+        case Operation::RTI:
+        case Operation::RTS:
+        case Operation::STP:
+        case Operation::WAI:
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,38 @@
+#include <breakpoints.hh>
+#include <algorithm>
+
+Breakpoints::Breakpoints() : _watchpoints(AddressCount)
+{
+}
+
+auto Breakpoints::Set(u16 address) -> void
+{
+    _breakpoints[address] = true;
+}
+
+auto Breakpoints::Remove(u16 address) -> void
+{
+    _breakpoints[address] = false;
+}
+
+auto Breakpoints::Watch(u16 address, Access access) -> void
+{
+    _watching += _watchpoints[address] == 0;
+    _watchpoints[address] |= static_cast<u8>(access);
+}
+
+auto Breakpoints::Unwatch(u16 address, Access access) -> void
+{
+    u8 watched = _watchpoints[address];
+    _watchpoints[address] &= ~static_cast<u8>(access);
+    _watching -= watched != 0 && _watchpoints[address] == 0;
+}
+
+auto Breakpoints::Clear() -> void
+{
+    _breakpoints.reset();
+    std::fill(_watchpoints.begin(), _watchpoints.end(), 0);
+    _watching = 0;
+    _hit.reset();
+    _triggered = false;
+}
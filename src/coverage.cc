@@ -0,0 +1,29 @@
+#include <coverage.hh>
+#include <bit>
+
+Coverage::Coverage() : _counts(MapSize)
+{
+    _edges.reserve(0x1000);
+}
+
+auto Coverage::Clear() -> void
+{
+    for (u16 edge : _edges)
+    {
+        _counts[edge] = 0;
+    }
+    _edges.clear();
+}
+
+auto Coverage::Bucket(u8 count) -> u8
+{
+    if (count < 4)
+    {
+        return count == 3 ? 0x04 : count;
+    }
+    if (count >= 32)
+    {
+        return count >= 128 ? 0x80 : 0x40;
+    }
+    return 0x10 << (std::bit_width(count) - 3) >> 1;
+}
@@ -1,412 +1,1147 @@
 #include <cpu.hh>
-#include <functional>
+#include <array>
+#include <breakpoints.hh>
+#include <coverage.hh>
+#include <limits>
+#include <profiler.hh>
+#include <trace.hh>
+
+using DecimalTable = std::array<u8, 0x200>;
+
+// Adds two BCD digits and a carry, indexed by carry << 8 | left << 4 | right.
+// Bits 0-3 hold the adjusted digit and bit 4 the decimal carry out, so the
+// same table adjusts the low digit and then the high digit with that carry.
+static constexpr DecimalTable DecimalDigitSum = []
+{
+    DecimalTable table = {};
+    for (u32 index = 0; index < table.size(); index++)
+    {
+        int sum = ((index >> 4) & 0x0F) + (index & 0x0F) + (index >> 8);
+        table[index] = sum >= 0x0A ? ((sum + 0x06) & 0x0F) | 0x10 : sum;
+    }
+    return table;
+}();
+
+// Subtracts a BCD digit and a borrow, indexed by borrow << 8 | left << 4 | right.
+// Bits 0-3 hold the adjusted digit and bit 4 the decimal borrow out.
+static constexpr DecimalTable DecimalDigitDifference = []
+{
+    DecimalTable table = {};
+    for (u32 index = 0; index < table.size(); index++)
+    {
+        int difference = ((index >> 4) & 0x0F) - (index & 0x0F) - (index >> 8);
+        table[index] = difference < 0 ? ((difference - 0x06) & 0x0F) | 0x10 : difference;
+    }
+    return table;
+}();
+
+template <Variant variant>
+static constexpr auto Edges = []
+{
+    std::array<bool, 0x100> table = {};
+    for (u32 opcode = 0; opcode < table.size(); opcode++)
+    {
+        switch (InstructionSet<variant>[opcode].operation)
+        {
+            case Operation::BBR:
+            case Operation::BBS:
+            case Operation::BCC:
+            case Operation::BCS:
+            case Operation::BEQ:
+            case Operation::BMI:
+            case Operation::BNE:
+            case Operation::BPL:
+            case Operation::BRA:
+            case Operation::BRK:
+            case Operation::BVC:
+            case Operation::BVS:
+            case Operation::JMP:
+            case Operation::JSR:
+            case Operation::RTI:
+            case Operation::RTS:
+                table[opcode] = true;
+                break;
+            default:
+                break;
+        }
+    }
+    return table;
+}();
+
+template <Variant variant>
+static constexpr auto Accesses = []
+{
+    std::array<u8, 0x100> table = {};
+    for (u32 opcode = 0; opcode < table.size(); opcode++)
+    {
+        switch (InstructionSet<variant>[opcode].operation)
+        {
+            case Operation::JMP:
+            case Operation::JSR:
+                break;
+            case Operation::SAX:
+            case Operation::SHA:
+            case Operation::SHX:
+            case Operation::SHY:
+            case Operation::STA:
+            case Operation::STX:
+            case Operation::STY:
+            case Operation::STZ:
+            case Operation::TAS:
+                table[opcode] = static_cast<u8>(Access::Write);
+                break;
+            case Operation::ASL:
+            case Operation::DCP:
+            case Operation::DEC:
+            case Operation::INC:
+            case Operation::ISC:
+            case Operation::LSR:
+            case Operation::RLA:
+            case Operation::RMB:
+            case Operation::ROL:
+            case Operation::ROR:
+            case Operation::RRA:
+            case Operation::SLO:
+            case Operation::SMB:
+            case Operation::SRE:
+            case Operation::TRB:
+            case Operation::TSB:
+                table[opcode] = static_cast<u8>(Access::ReadWrite);
+                break;
+            default:
+                table[opcode] = static_cast<u8>(Access::Read);
+                break;
+        }
+    }
+    return table;
+}();
+
+template <Variant variant>
+static constexpr auto StackAccesses = []
+{
+    std::array<u8, 0x100> table = {};
+    for (u32 opcode = 0; opcode < table.size(); opcode++)
+    {
+        switch (InstructionSet<variant>[opcode].operation)
+        {
+            case Operation::BRK:
+            case Operation::JSR:
+            case Operation::PHA:
+            case Operation::PHP:
+            case Operation::PHX:
+            case Operation::PHY:
+                table[opcode] = static_cast<u8>(Access::Write);
+                break;
+            case Operation::PLA:
+            case Operation::PLP:
+            case Operation::PLX:
+            case Operation::PLY:
+            case Operation::RTI:
+            case Operation::RTS:
+                table[opcode] = static_cast<u8>(Access::Read);
+                break;
+            default:
+                break;
+        }
+    }
+    return table;
+}();
 
 CPU::CPU()
 {
     Reset();
 }
 
-auto CPU::Reset() -> void
+auto CPU::Reset() -> void
+{
+    PC = 0x0000;
+    SP = 0xFF;
+    A = 0x00;
+    X = 0x00;
+    Y = 0x00;
+    SetStatus(0x00);
+    _cycles = 0;
+    _jammed = false;
+}
+
+auto CPU::Reset(Memory& memory) -> void
+{
+    Reset();
+    PC = memory.Read(ResetVector) | memory.Read(ResetVector + 1) << 8;
+    SP = 0xFD;
+    IF = 1;
+    _cycles = 7;
+}
+
+template <Variant variant>
+auto CPU::RunFor(Memory& memory, u64 instructions, u64 cycles) -> RunResult
+{
+    return Loop<variant, void>(memory, instructions, cycles, nullptr);
+}
+
+template <Variant variant>
+auto CPU::RunFor(Memory& memory, u64 instructions, u64 cycles, Profiler& profiler) -> RunResult
+{
+    profiler._variant = variant;
+    return Loop<variant>(memory, instructions, cycles, &profiler);
+}
+
+template <Variant variant>
+auto CPU::RunFor(Memory& memory, u64 instructions, u64 cycles, Trace& trace) -> RunResult
+{
+    trace._variant = variant;
+    return Loop<variant>(memory, instructions, cycles, &trace);
+}
+
+template <Variant variant>
+auto CPU::RunFor(Memory& memory, u64 instructions, u64 cycles, Coverage& coverage) -> RunResult
+{
+    return Loop<variant>(memory, instructions, cycles, &coverage);
+}
+
+template <Variant variant>
+auto CPU::RunFor(Memory& memory, u64 instructions, u64 cycles, Breakpoints& breakpoints) -> RunResult
+{
+    return Loop<variant>(memory, instructions, cycles, &breakpoints);
+}
+
+template auto CPU::RunFor<Variant::Nmos>(Memory& memory, u64 instructions, u64 cycles) -> RunResult;
+template auto CPU::RunFor<Variant::Cmos>(Memory& memory, u64 instructions, u64 cycles) -> RunResult;
+template auto CPU::RunFor<Variant::Strict>(Memory& memory, u64 instructions, u64 cycles) -> RunResult;
+template auto CPU::RunFor<Variant::Nmos>(Memory& memory, u64 instructions, u64 cycles, Profiler& profiler) -> RunResult;
+template auto CPU::RunFor<Variant::Cmos>(Memory& memory, u64 instructions, u64 cycles, Profiler& profiler) -> RunResult;
+template auto CPU::RunFor<Variant::Strict>(Memory& memory, u64 instructions, u64 cycles, Profiler& profiler) -> RunResult;
+template auto CPU::RunFor<Variant::Nmos>(Memory& memory, u64 instructions, u64 cycles, Trace& trace) -> RunResult;
+template auto CPU::RunFor<Variant::Cmos>(Memory& memory, u64 instructions, u64 cycles, Trace& trace) -> RunResult;
+template auto CPU::RunFor<Variant::Strict>(Memory& memory, u64 instructions, u64 cycles, Trace& trace) -> RunResult;
+template auto CPU::RunFor<Variant::Nmos>(Memory& memory, u64 instructions, u64 cycles, Coverage& coverage) -> RunResult;
+template auto CPU::RunFor<Variant::Cmos>(Memory& memory, u64 instructions, u64 cycles, Coverage& coverage) -> RunResult;
+template auto CPU::RunFor<Variant::Strict>(Memory& memory, u64 instructions, u64 cycles, Coverage& coverage) -> RunResult;
+template auto CPU::RunFor<Variant::Nmos>(Memory& memory, u64 instructions, u64 cycles, Breakpoints& breakpoints) -> RunResult;
+template auto CPU::RunFor<Variant::Cmos>(Memory& memory, u64 instructions, u64 cycles, Breakpoints& breakpoints) -> RunResult;
+template auto CPU::RunFor<Variant::Strict>(Memory& memory, u64 instructions, u64 cycles, Breakpoints& breakpoints) -> RunResult;
+
+template <Variant variant, typename Observer>
+auto CPU::Loop(Memory& memory, u64 instructions, u64 cycles, Observer* observer) -> RunResult
+{
+    RunResult result = { StopReason::Break, 0, 0 };
+    u64 start = _cycles;
+    Bind(memory);
+
+    while (BF == 0)
+    {
+        if (result.instructions == instructions)
+        {
+            result.reason = StopReason::InstructionLimit;
+            break;
+        }
+
+        if (_cycles - start >= cycles)
+        {
+            result.reason = StopReason::CycleLimit;
+            break;
+        }
+
+        if (_cycles >= *_deadline) [[unlikely]]
+        {
+            u16 pc = PC;
+            Poll(memory, variant);
+            if constexpr (std::is_same_v<Observer, Coverage>)
+            {
+                if (PC != pc)
+                {
+                    observer->Record(pc, PC);
+                }
+            }
+        }
+
+        if constexpr (std::is_same_v<Observer, Breakpoints>)
+        {
+            if (result.instructions != 0 && observer->IsSet(PC)) [[unlikely]]
+            {
+                result.reason = StopReason::Breakpoint;
+                break;
+            }
+        }
+
+        if constexpr (std::is_void_v<Observer>)
+        {
+            (void)observer;
+            Execute<variant>(memory, memory.Read(PC++));
+        }
+        else
+        {
+            Execute<variant>(memory, *observer);
+        }
+        result.instructions++;
+
+        if constexpr (std::is_same_v<Observer, Breakpoints>)
+        {
+            if (observer->_triggered) [[unlikely]]
+            {
+                observer->_triggered = false;
+                result.reason = StopReason::Watchpoint;
+                break;
+            }
+        }
+    }
+
+    if (BF != 0)
+    {
+        result.reason = GetStopReason();
+    }
+
+    result.cycles = _cycles - start;
+    return result;
+}
+
+auto CPU::Attach(InterruptController& interrupts) -> void
+{
+    _interrupts = &interrupts;
+    _deadline = &interrupts.GetDeadline();
+    interrupts._masked = false;
+    interrupts.Update();
+}
+
+auto CPU::Detach() -> void
+{
+    _interrupts = nullptr;
+    _deadline = &InterruptController::Never;
+}
+
+auto CPU::Poll(Memory& memory, Variant variant) -> void
+{
+    _interrupts->Dispatch(_cycles);
+    if (_interrupts->_nmi)
+    {
+        _interrupts->_nmi = false;
+        _interrupts->Update();
+        Interrupt(memory, NmiVector, 0x20, variant);
+        _cycles += 7;
+    }
+    else if (_interrupts->_irq != 0 && IF == 0)
+    {
+        Interrupt(memory, IrqVector, 0x20, variant);
+        _cycles += 7;
+    }
+    else if (_interrupts->_irq != 0)
+    {
+        _interrupts->_masked = true;
+        _interrupts->Update();
+    }
+}
+
+auto CPU::Unmask() -> void
+{
+    if (_interrupts != nullptr && _interrupts->_masked && IF == 0)
+    {
+        _interrupts->_masked = false;
+        _interrupts->Update();
+    }
+}
+
+auto CPU::Interrupt(Memory& memory, u16 vector, u8 status, Variant variant) -> void
+{
+    Push(memory, PC >> 8);
+    Push(memory, PC & 0xFF);
+    Push(memory, GetStatus() | status);
+    IF = 1;
+    if (variant == Variant::Cmos)
+    {
+        DF = 0;
+    }
+    PC = memory.Read(vector) | memory.Read(vector + 1) << 8;
+}
+
+template <AddressingMode addressingMode>
+auto CPU::Address(Memory& memory, u16 operand) -> u16
+{
+    if constexpr (addressingMode == AddressingMode::ZeroPage || addressingMode == AddressingMode::Absolute || addressingMode == AddressingMode::Indirect)
+    {
+        return operand;
+    }
+    else if constexpr (addressingMode == AddressingMode::ZeroPageX)
+    {
+        return static_cast<u8>(operand + X);
+    }
+    else if constexpr (addressingMode == AddressingMode::ZeroPageY)
+    {
+        return static_cast<u8>(operand + Y);
+    }
+    else if constexpr (addressingMode == AddressingMode::AbsoluteX)
+    {
+        return operand + X;
+    }
+    else if constexpr (addressingMode == AddressingMode::AbsoluteY)
+    {
+        return operand + Y;
+    }
+    else if constexpr (addressingMode == AddressingMode::IndirectX)
+    {
+        u8 pointer = operand + X;
+        u16 address = ReadZeroPage(memory, pointer);
+        address |= ReadZeroPage(memory, pointer + 1) << 8;
+        return address;
+    }
+    else if constexpr (addressingMode == AddressingMode::IndirectY)
+    {
+        u8 pointer = operand;
+        u16 address = ReadZeroPage(memory, pointer);
+        address |= ReadZeroPage(memory, pointer + 1) << 8;
+        return address + Y;
+    }
+    else if constexpr (addressingMode == AddressingMode::ZeroPageIndirect)
+    {
+        u8 pointer = operand;
+        u16 address = ReadZeroPage(memory, pointer);
+        address |= ReadZeroPage(memory, pointer + 1) << 8;
+        return address;
+    }
+    else if constexpr (addressingMode == AddressingMode::AbsoluteIndexedIndirect)
+    {
+        u16 pointer = operand + X;
+        u16 address = memory.Read(pointer);
+        address |= memory.Read(static_cast<u16>(pointer + 1)) << 8;
+        return address;
+    }
+    else if constexpr (addressingMode == AddressingMode::ZeroPageRelative)
+    {
+        return operand & 0xFF;
+    }
+    else
+    {
+        static_assert(addressingMode != addressingMode, "addressing mode has no effective address");
+    }
+}
+
+template <AddressingMode addressingMode, bool pageCrossCycle>
+auto CPU::Fetch(Memory& memory, u16 operand) -> std::pair<u8, u16>
+{
+    if constexpr (addressingMode == AddressingMode::Immediate || addressingMode == AddressingMode::Relative)
+    {
+        return std::make_pair(operand, PC - 1);
+    }
+    else if constexpr (addressingMode == AddressingMode::Accumulator)
+    {
+        return std::make_pair(A, 0);
+    }
+    else if constexpr (addressingMode == AddressingMode::Implicit)
+    {
+        return std::make_pair(0, 0);
+    }
+    else
+    {
+        u16 address = Address<addressingMode>(memory, operand);
+        if constexpr (pageCrossCycle && addressingMode == AddressingMode::AbsoluteX)
+        {
+            _cycles += PageCrossed(address - X, address);
+        }
+        else if constexpr (pageCrossCycle && (addressingMode == AddressingMode::AbsoluteY || addressingMode == AddressingMode::IndirectY))
+        {
+            _cycles += PageCrossed(address - Y, address);
+        }
+        if constexpr (addressingMode == AddressingMode::ZeroPage || addressingMode == AddressingMode::ZeroPageX || addressingMode == AddressingMode::ZeroPageY)
+        {
+            return std::make_pair(ReadZeroPage(memory, address), address);
+        }
+        return std::make_pair(memory.Read(address), address);
+    }
+}
+
+auto CPU::Address(Memory& memory, AddressingMode addressingMode, u16 operand) -> std::optional<u16>
+{
+    switch (addressingMode)
+    {
+        case AddressingMode::ZeroPage:
+            return Address<AddressingMode::ZeroPage>(memory, operand);
+        case AddressingMode::ZeroPageX:
+            return Address<AddressingMode::ZeroPageX>(memory, operand);
+        case AddressingMode::ZeroPageY:
+            return Address<AddressingMode::ZeroPageY>(memory, operand);
+        case AddressingMode::Absolute:
+            return Address<AddressingMode::Absolute>(memory, operand);
+        case AddressingMode::AbsoluteX:
+            return Address<AddressingMode::AbsoluteX>(memory, operand);
+        case AddressingMode::AbsoluteY:
+            return Address<AddressingMode::AbsoluteY>(memory, operand);
+        case AddressingMode::IndirectX:
+            return Address<AddressingMode::IndirectX>(memory, operand);
+        case AddressingMode::IndirectY:
+            return Address<AddressingMode::IndirectY>(memory, operand);
+        case AddressingMode::ZeroPageIndirect:
+            return Address<AddressingMode::ZeroPageIndirect>(memory, operand);
+        case AddressingMode::ZeroPageRelative:
+            return Address<AddressingMode::ZeroPageRelative>(memory, operand);
+        default:
+            return std::nullopt;
+    }
+}
+
+auto CPU::PageCrossed(u16 from, u16 to) -> bool
+{
+    return (from ^ to) & 0xFF00;
+}
+
+template <Variant variant>
+auto CPU::Execute(Memory& memory, u8 opcode) -> void
+{
+    Handlers<variant>()[opcode](*this, memory);
+}
+
+template <Variant variant>
+auto CPU::Execute(Memory& memory, Profiler& profiler) -> void
+{
+    u16 pc = PC;
+    u8 sp = SP;
+    u64 cycles = _cycles;
+    u8 opcode = memory.Read(pc);
+    Instruction instruction = InstructionSet<variant>[opcode];
+
+    u8 length = Length(instruction.addressingMode);
+    u16 operand = length > 1 ? memory.Read(pc + 1) : 0;
+    operand |= length > 2 ? memory.Read(pc + 2) << 8 : 0;
+
+    std::optional<u16> address = Accesses<variant>[opcode] != 0 ? Address(memory, instruction.addressingMode, operand) : std::nullopt;
+    if (address.has_value())
+    {
+        if ((Accesses<variant>[opcode] & static_cast<u8>(Access::Read)) != 0)
+        {
+            profiler.Read(*address);
+        }
+        if ((Accesses<variant>[opcode] & static_cast<u8>(Access::Write)) != 0)
+        {
+            profiler.Write(*address);
+        }
+    }
+
+    PC += length;
+    DecodedHandlers<variant>()[opcode](*this, memory, operand);
+
+    if (StackAccesses<variant>[opcode] == static_cast<u8>(Access::Write))
+    {
+        for (u8 stack = SP; stack != sp; stack++)
+        {
+            profiler.Write(0x0100 | static_cast<u8>(stack + 1));
+        }
+    }
+    else if (StackAccesses<variant>[opcode] == static_cast<u8>(Access::Read))
+    {
+        for (u8 stack = sp; stack != SP; stack++)
+        {
+            profiler.Read(0x0100 | static_cast<u8>(stack + 1));
+        }
+    }
+
+    profiler.Execute(pc, opcode, _cycles - cycles);
+    if (instruction.operation == Operation::JSR)
+    {
+        profiler.Call(PC, SP, _cycles);
+    }
+    else if (SP > sp)
+    {
+        profiler.Return(SP, _cycles);
+    }
+}
+
+template <Variant variant>
+auto CPU::Execute(Memory& memory, Trace& trace) -> void
+{
+    u8 opcode = memory.Read(PC);
+    u8 length = Length(InstructionSet<variant>[opcode].addressingMode);
+    u16 operand = length > 1 ? memory.Read(PC + 1) : 0;
+    operand |= length > 2 ? memory.Read(PC + 2) << 8 : 0;
+    trace.Record({ _cycles, PC, operand, opcode, A, X, Y, SP, GetStatus() });
+
+    PC += length;
+    DecodedHandlers<variant>()[opcode](*this, memory, operand);
+}
+
+template <Variant variant>
+auto CPU::Execute(Memory& memory, Coverage& coverage) -> void
+{
+    u16 pc = PC;
+    u8 opcode = memory.Read(PC++);
+    Handlers<variant>()[opcode](*this, memory);
+    if (Edges<variant>[opcode])
+    {
+        coverage.Record(pc, PC);
+    }
+}
+
+template <Variant variant>
+auto CPU::Execute(Memory& memory, Breakpoints& breakpoints) -> void
+{
+    if (!breakpoints.IsWatching()) [[likely]]
+    {
+        Execute<variant>(memory, memory.Read(PC++));
+        return;
+    }
+
+    u16 pc = PC;
+    u8 sp = SP;
+    u8 opcode = memory.Read(pc);
+    Instruction instruction = InstructionSet<variant>[opcode];
+
+    u8 length = Length(instruction.addressingMode);
+    u16 operand = length > 1 ? memory.Read(pc + 1) : 0;
+    operand |= length > 2 ? memory.Read(pc + 2) << 8 : 0;
+    std::optional<u16> address = Accesses<variant>[opcode] != 0 ? Address(memory, instruction.addressingMode, operand) : std::nullopt;
+
+    PC += length;
+    DecodedHandlers<variant>()[opcode](*this, memory, operand);
+
+    if (address.has_value())
+    {
+        for (Access access : { Access::Read, Access::Write })
+        {
+            if ((Accesses<variant>[opcode] & static_cast<u8>(access)) != 0)
+            {
+                breakpoints.Check(*address, access);
+            }
+        }
+    }
+
+    if (StackAccesses<variant>[opcode] == static_cast<u8>(Access::Write))
+    {
+        for (u8 stack = SP; stack != sp; stack++)
+        {
+            breakpoints.Check(0x0100 | static_cast<u8>(stack + 1), Access::Write);
+        }
+    }
+    else if (StackAccesses<variant>[opcode] == static_cast<u8>(Access::Read))
+    {
+        for (u8 stack = sp; stack != SP; stack++)
+        {
+            breakpoints.Check(0x0100 | static_cast<u8>(stack + 1), Access::Read);
+        }
+    }
+}
+
+template <Variant variant>
+auto CPU::Handlers() -> const Handler*
+{
+    static constexpr auto handlers = []<std::size_t... opcodes>(std::index_sequence<opcodes...>)
+    {
+        return std::array<Handler, 0x100>{ &CPU::Execute<variant, opcodes>... };
+    }(std::make_index_sequence<0x100>());
+
+    return handlers.data();
+}
+
+template <Variant variant>
+auto CPU::DecodedHandlers() -> const DecodedHandler*
+{
+    static constexpr auto handlers = []<std::size_t... opcodes>(std::index_sequence<opcodes...>)
+    {
+        return std::array<DecodedHandler, 0x100>{ &CPU::Dispatch<variant, opcodes>... };
+    }(std::make_index_sequence<0x100>());
+
+    return handlers.data();
+}
+
+auto CPU::Handlers(Variant variant) -> const Handler*
+{
+    switch (variant)
+    {
+        case Variant::Cmos:
+            return Handlers<Variant::Cmos>();
+        case Variant::Strict:
+            return Handlers<Variant::Strict>();
+        default:
+            return Handlers<Variant::Nmos>();
+    }
+}
+
+auto CPU::DecodedHandlers(Variant variant) -> const DecodedHandler*
+{
+    switch (variant)
+    {
+        case Variant::Cmos:
+            return DecodedHandlers<Variant::Cmos>();
+        case Variant::Strict:
+            return DecodedHandlers<Variant::Strict>();
+        default:
+            return DecodedHandlers<Variant::Nmos>();
+    }
+}
+
+template <Variant variant, u8 opcode>
+auto CPU::Execute(CPU& cpu, Memory& memory) -> void
+{
+    constexpr u8 length = Length(InstructionSet<variant>[opcode].addressingMode);
+
+    u16 operand = 0;
+    if constexpr (length > 1)
+    {
+        operand = memory.Read(cpu.PC++);
+    }
+    if constexpr (length > 2)
+    {
+        operand |= memory.Read(cpu.PC++) << 8;
+    }
+    Dispatch<variant, opcode>(cpu, memory, operand);
+}
+
+template <Variant variant, u8 opcode>
+auto CPU::Dispatch(CPU& cpu, Memory& memory, u16 operand) -> void
+{
+    constexpr Instruction instruction = InstructionSet<variant>[opcode];
+    constexpr AddressingMode addressingMode = instruction.addressingMode;
+
+    cpu._cycles += instruction.cycles;
+
+    if constexpr (instruction.operation == Operation::ADC)
+    {
+        cpu.ADC<variant, addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::AND)
+    {
+        cpu.AND<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ASL)
+    {
+        cpu.ASL<variant, addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BCC)
+    {
+        cpu.BCC<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BCS)
+    {
+        cpu.BCS<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BEQ)
+    {
+        cpu.BEQ<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BIT)
+    {
+        cpu.BIT<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BMI)
+    {
+        cpu.BMI<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BNE)
+    {
+        cpu.BNE<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BPL)
+    {
+        cpu.BPL<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BRK)
+    {
+        cpu.BRK<variant, addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BVC)
+    {
+        cpu.BVC<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BVS)
+    {
+        cpu.BVS<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::CLC)
+    {
+        cpu.CLC<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::CLD)
+    {
+        cpu.CLD<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::CLI)
+    {
+        cpu.CLI<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::CLV)
+    {
+        cpu.CLV<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::CMP)
+    {
+        cpu.CMP<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::CPX)
+    {
+        cpu.CPX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::CPY)
+    {
+        cpu.CPY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::DEC)
+    {
+        cpu.DEC<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::DEX)
+    {
+        cpu.DEX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::DEY)
+    {
+        cpu.DEY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::EOR)
+    {
+        cpu.EOR<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::INC)
+    {
+        cpu.INC<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::INX)
+    {
+        cpu.INX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::INY)
+    {
+        cpu.INY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::JMP)
+    {
+        cpu.JMP<variant, addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::JSR)
+    {
+        cpu.JSR<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::LDA)
+    {
+        cpu.LDA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::LDX)
+    {
+        cpu.LDX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::LDY)
+    {
+        cpu.LDY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::LSR)
+    {
+        cpu.LSR<variant, addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::NOP)
+    {
+        cpu.NOP<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ORA)
+    {
+        cpu.ORA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::PHA)
+    {
+        cpu.PHA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::PHP)
+    {
+        cpu.PHP<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::PLA)
+    {
+        cpu.PLA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::PLP)
+    {
+        cpu.PLP<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ROL)
+    {
+        cpu.ROL<variant, addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ROR)
+    {
+        cpu.ROR<variant, addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::RTI)
+    {
+        cpu.RTI<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::RTS)
+    {
+        cpu.RTS<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SBC)
+    {
+        cpu.SBC<variant, addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SEC)
+    {
+        cpu.SEC<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SED)
+    {
+        cpu.SED<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SEI)
+    {
+        cpu.SEI<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::STA)
+    {
+        cpu.STA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::STX)
+    {
+        cpu.STX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::STY)
+    {
+        cpu.STY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TAX)
+    {
+        cpu.TAX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TAY)
+    {
+        cpu.TAY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TSX)
+    {
+        cpu.TSX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TXA)
+    {
+        cpu.TXA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TXS)
+    {
+        cpu.TXS<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TYA)
+    {
+        cpu.TYA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ALR)
+    {
+        cpu.ALR<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ANC)
+    {
+        cpu.ANC<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ANE)
+    {
+        cpu.ANE<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ARR)
+    {
+        cpu.ARR<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::DCP)
+    {
+        cpu.DCP<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::ISC)
+    {
+        cpu.ISC<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::JAM)
+    {
+        cpu.JAM<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::LAS)
+    {
+        cpu.LAS<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::LAX)
+    {
+        cpu.LAX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::LXA)
+    {
+        cpu.LXA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::RLA)
+    {
+        cpu.RLA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::RRA)
+    {
+        cpu.RRA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SAX)
+    {
+        cpu.SAX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SBX)
+    {
+        cpu.SBX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SHA)
+    {
+        cpu.SHA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SHX)
+    {
+        cpu.SHX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SHY)
+    {
+        cpu.SHY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SLO)
+    {
+        cpu.SLO<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SRE)
+    {
+        cpu.SRE<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TAS)
+    {
+        cpu.TAS<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BBR)
+    {
+        cpu.BBR<(opcode >> 4) & 0x07>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BBS)
+    {
+        cpu.BBS<(opcode >> 4) & 0x07>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::BRA)
+    {
+        cpu.BRA<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::PHX)
+    {
+        cpu.PHX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::PHY)
+    {
+        cpu.PHY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::PLX)
+    {
+        cpu.PLX<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::PLY)
+    {
+        cpu.PLY<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::RMB)
+    {
+        cpu.RMB<(opcode >> 4) & 0x07>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::SMB)
+    {
+        cpu.SMB<(opcode >> 4) & 0x07>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::STP)
+    {
+        cpu.STP<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::STZ)
+    {
+        cpu.STZ<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TRB)
+    {
+        cpu.TRB<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::TSB)
+    {
+        cpu.TSB<addressingMode>(memory, operand);
+    }
+    else if constexpr (instruction.operation == Operation::WAI)
+    {
+        cpu.WAI<addressingMode>(memory, operand);
+    }
+}
+
+auto CPU::SetResult(u8 result) -> void
 {
-    PC = 0x0600;
-    SP = 0xFF;
-    A = 0x00;
-    X = 0x00;
-    Y = 0x00;
-    PS = 0x00;
+    _zero = result;
+    _negative = result;
 }
 
-auto CPU::Run(Memory& memory) -> void
+template <Variant variant>
+auto CPU::DecimalSum(u8 data) -> void
 {
-    while (BF == 0)
+    u8 low = DecimalDigitSum[_carry << 8 | (A & 0x0F) << 4 | (data & 0x0F)];
+    u8 high = DecimalDigitSum[(low >> 4) << 8 | (A >> 4) << 4 | data >> 4];
+    u8 result = high << 4 | (low & 0x0F);
+
+    // The NMOS part takes N and V from the sum before the high digit is
+    // adjusted, and Z from the binary sum. The CMOS part takes N and Z from the result.
+    u8 sum = (A & 0xF0) + (data & 0xF0) + low;
+    _overflow = (~(A ^ data) & (A ^ sum) & 0x80) != 0;
+    if constexpr (variant == Variant::Cmos)
+    {
+        SetResult(result);
+    }
+    else
     {
-        auto [data, address] = Fetch(memory);
-        Execute(memory, static_cast<OperationCode>(data));
+        _zero = A + data + _carry;
+        _negative = sum;
     }
+    _carry = high >> 4;
+    A = result;
 }
 
-auto CPU::Fetch(Memory& memory, AddressingMode addressingMode) -> std::pair<u8, u16>
+template <Variant variant>
+auto CPU::DecimalDifference(u8 data) -> void
 {
-    switch (addressingMode)
+    u8 borrow = 1 - _carry;
+    u16 binary = A - data - borrow;
+    u8 low = DecimalDigitDifference[borrow << 8 | (A & 0x0F) << 4 | (data & 0x0F)];
+
+    // Flags come from the binary difference on the NMOS part. The CMOS part
+    // adjusts the binary difference instead of each digit, and takes N and Z from it.
+    u8 result;
+    if constexpr (variant == Variant::Cmos)
     {
-        case AddressingMode::Immediate:
-        {
-            u16 data = memory.Read(PC++);
-            return std::make_pair(data, PC - 1);
-        }
-        case AddressingMode::Accumulator:
-        {
-            return std::make_pair(A, 0);
-        }
-        case AddressingMode::ZeroPage:
-        {
-            u16 address = memory.Read(PC++);
-            return std::make_pair(memory.Read(address), address);
-        }
-        case AddressingMode::ZeroPageX:
-        {
-            u16 address = memory.Read(PC++);
-            address += X;
-            return std::make_pair(memory.Read(address), address);
-        }
-        case AddressingMode::ZeroPageY:
-        {
-            u16 address = memory.Read(PC++);
-            address += Y;
-            return std::make_pair(memory.Read(address), address);
-        }
-        case AddressingMode::Relative:
-        {
-            u16 data = memory.Read(PC++);
-            return std::make_pair(data, PC - 1);
-        }
-        case AddressingMode::Absolute:
-        {
-            u16 address = memory.Read(PC++);
-            address |= memory.Read(PC++) << 8;
-            return std::make_pair(memory.Read(address), address);
-        }
-        case AddressingMode::AbsoluteX:
-        {
-            u16 address = memory.Read(PC++);
-            address |= memory.Read(PC++) << 8;
-            address += X;
-            return std::make_pair(memory.Read(address), address);
-        }
-        case AddressingMode::AbsoluteY:
-        {
-            u16 address = memory.Read(PC++);
-            address |= memory.Read(PC++) << 8;
-            address += Y;
-            return std::make_pair(memory.Read(address), address);
-        }
-        case AddressingMode::Indirect:
-        {
-            u16 address = memory.Read(PC++);
-            address |= memory.Read(PC++) << 8;
-            return std::make_pair(memory.Read(address), address);
-        }
-        case AddressingMode::IndirectX:
-        {
-            u16 address = memory.Read(PC++);
-            address += X;
-            return std::make_pair(memory.Read(address), address);
-        }
-        case AddressingMode::IndirectY:
-        {
-            u16 address = memory.Read(PC++);
-            return std::make_pair(memory.Read(address) + Y, address);
-        }
-        case AddressingMode::Implicit:
-        {
-            return std::make_pair(0, 0);
-        }
+        result = binary - (binary >= 0x100 ? 0x60 : 0) - (low & 0x10 ? 0x06 : 0);
+        SetResult(result);
     }
+    else
+    {
+        u8 high = DecimalDigitDifference[(low >> 4) << 8 | (A >> 4) << 4 | data >> 4];
+        result = high << 4 | (low & 0x0F);
+        SetResult(binary);
+    }
+    _carry = binary < 0x100;
+    _overflow = ((A ^ binary) & (A ^ data) & 0x80) != 0;
+    A = result;
+}
+
+auto CPU::GetStopReason() const -> StopReason
+{
+    return _jammed ? StopReason::IllegalOpcode : StopReason::Break;
 }
 
-auto CPU::Execute(Memory& memory, OperationCode opcode) -> void
-{
-    static const std::function<void(Memory&)> instructions[0x100] =
-    {
-        // 0x00
-        [this](Memory& memory) { BRK(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ORA(memory, AddressingMode::IndirectX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ORA(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { ASL(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { PHP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ORA(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { ASL(memory, AddressingMode::Accumulator); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ORA(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { ASL(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x10
-        [this](Memory& memory) { BPL(memory, AddressingMode::Relative); },
-        [this](Memory& memory) { ORA(memory, AddressingMode::IndirectY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ORA(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { ASL(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CLC(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ORA(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ORA(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { ASL(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x20
-        [this](Memory& memory) { JSR(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { AND(memory, AddressingMode::IndirectX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { BIT(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { AND(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { ROL(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { PLP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { AND(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { ROL(memory, AddressingMode::Accumulator); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { BIT(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { AND(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { ROL(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x30
-        [this](Memory& memory) { BMI(memory, AddressingMode::Relative); },
-        [this](Memory& memory) { AND(memory, AddressingMode::IndirectY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { AND(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { ROL(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { SEC(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { AND(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { AND(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { ROL(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x40
-        [this](Memory& memory) { RTI(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { EOR(memory, AddressingMode::IndirectX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { EOR(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { LSR(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { PHA(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { EOR(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { LSR(memory, AddressingMode::Accumulator); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { JMP(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { EOR(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { LSR(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x50
-        [this](Memory& memory) { BVC(memory, AddressingMode::Relative); },
-        [this](Memory& memory) { EOR(memory, AddressingMode::IndirectY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { EOR(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { LSR(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CLI(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { EOR(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { EOR(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { LSR(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x60
-        [this](Memory& memory) { RTS(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ADC(memory, AddressingMode::IndirectX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ADC(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { ROR(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { PLA(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ADC(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { ROR(memory, AddressingMode::Accumulator); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { JMP(memory, AddressingMode::Indirect); },
-        [this](Memory& memory) { ADC(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { ROR(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x70
-        [this](Memory& memory) { BVS(memory, AddressingMode::Relative); },
-        [this](Memory& memory) { ADC(memory, AddressingMode::IndirectY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ADC(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { ROR(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { SEI(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ADC(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { ADC(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { ROR(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x80
-        [this](Memory& memory) { NOP(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { STA(memory, AddressingMode::IndirectX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { STY(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { STA(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { STX(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { DEY(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { TXA(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { STY(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { STA(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { STX(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0x90
-        [this](Memory& memory) { BCC(memory, AddressingMode::Relative); },
-        [this](Memory& memory) { STA(memory, AddressingMode::IndirectY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { STY(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { STA(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { STX(memory, AddressingMode::ZeroPageY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { TYA(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { STA(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { TXS(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { STA(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0xA0
-        [this](Memory& memory) { LDY(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { LDA(memory, AddressingMode::IndirectX); },
-        [this](Memory& memory) { LDX(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { LDY(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { LDA(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { LDX(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { TAY(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { LDA(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { TAX(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { LDY(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { LDA(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { LDX(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0xB0
-        [this](Memory& memory) { BCS(memory, AddressingMode::Relative); },
-        [this](Memory& memory) { LDA(memory, AddressingMode::IndirectY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { LDY(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { LDA(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { LDX(memory, AddressingMode::ZeroPageY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CLV(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { LDA(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { TSX(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { LDY(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { LDA(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { LDX(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0xC0
-        [this](Memory& memory) { CPY(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { CMP(memory, AddressingMode::IndirectX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CPY(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { CMP(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { DEC(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { INY(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CMP(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { DEX(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CPY(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { CMP(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { DEC(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0xD0
-        [this](Memory& memory) { BNE(memory, AddressingMode::Relative); },
-        [this](Memory& memory) { CMP(memory, AddressingMode::IndirectY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CMP(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { DEC(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CLD(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CMP(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CMP(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { DEC(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0xE0
-        [this](Memory& memory) { CPX(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { SBC(memory, AddressingMode::IndirectX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CPX(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { SBC(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { INC(memory, AddressingMode::ZeroPage); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { INX(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { SBC(memory, AddressingMode::Immediate); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { CPX(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { SBC(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { INC(memory, AddressingMode::Absolute); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-
-        // 0xF0
-        [this](Memory& memory) { BEQ(memory, AddressingMode::Relative); },
-        [this](Memory& memory) { SBC(memory, AddressingMode::IndirectY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { SBC(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { INC(memory, AddressingMode::ZeroPageX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { SED(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { SBC(memory, AddressingMode::AbsoluteY); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-        [this](Memory& memory) { SBC(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { INC(memory, AddressingMode::AbsoluteX); },
-        [this](Memory& memory) { NOP(memory, AddressingMode::Implicit); },
-    };
-
-    instructions[static_cast<u16>(opcode)](memory);
+template <AddressingMode addressingMode>
+auto CPU::Store(Memory& memory, u16 address, u8 data) -> void
+{
+    if constexpr (addressingMode == AddressingMode::ZeroPage || addressingMode == AddressingMode::ZeroPageX || addressingMode == AddressingMode::ZeroPageY)
+    {
+        WriteZeroPage(memory, address, data);
+    }
+    else
+    {
+        memory.Write(address, data);
+    }
 }
 
 auto CPU::Push(Memory& memory, u8 value) -> void
 {
+    if (_stack != nullptr) [[likely]]
+    {
+        _stack[SP--] = value;
+        return;
+    }
     memory.Write(0x0100 + SP--, value);
 }
 
 auto CPU::Pop(Memory& memory) -> u8
 {
+    if (_stack != nullptr) [[likely]]
+    {
+        return _stack[++SP];
+    }
     return memory.Read(0x0100 + ++SP);
 }
 
@@ -414,487 +1149,886 @@ auto CPU::BranchIf(bool condition, u8 offset) -> void
 {
     if (condition)
     {
-        PC += offset;
+        u16 target = PC + static_cast<signed char>(offset);
+        _cycles += 1 + PageCrossed(PC, target);
+        PC = target;
     }
 }
 
 auto CPU::Compare(u8 left, u8 right) -> void
 {
     u16 result = left - right;
-    CF = result < 0x100;
-    ZF = result == 0;
-    NF = result & 0x80;
+    _carry = result < 0x100;
+    SetResult(result);
 }
 
-auto CPU::ADC(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::StoreHigh(Memory& memory, u16 operand, u8 value) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    u16 result = A + data + CF;
-    CF = result > 0xFF;
-    VF = (~(A ^ data) & (A ^ result) & 0x80) != 0;
+    u16 address = Address<addressingMode>(memory, operand);
+    u16 base = address - (addressingMode == AddressingMode::AbsoluteX ? X : Y);
+    value &= (base >> 8) + 1;
+    if (PageCrossed(base, address))
+    {
+        address = (address & 0x00FF) | value << 8;
+    }
+    memory.Write(address, value);
+}
+
+template <Variant variant, AddressingMode addressingMode>
+auto CPU::ADC(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    if (DF != 0) [[unlikely]]
+    {
+        if constexpr (variant == Variant::Cmos)
+        {
+            _cycles++;
+        }
+        return DecimalSum<variant>(data);
+    }
+
+    u16 result = A + data + _carry;
+    _carry = result > 0xFF;
+    _overflow = (~(A ^ data) & (A ^ result) & 0x80) != 0;
     A = result;
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
 }
 
-auto CPU::AND(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::AND(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     A &= data;
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
 }
 
-auto CPU::ASL(Memory& memory, AddressingMode addressingMode) -> void
+template <Variant variant, AddressingMode addressingMode>
+auto CPU::ASL(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    CF = data & 0x80;
+    auto [data, address] = Fetch<addressingMode, variant == Variant::Cmos>(memory, operand);
+    _carry = (data & 0x80) != 0;
     data <<= 1;
-    ZF = data == 0;
-    NF = data & 0x80;
+    SetResult(data);
 
-    if (addressingMode == AddressingMode::Accumulator)
+    if constexpr (addressingMode == AddressingMode::Accumulator)
     {
         A = data;
         return;
     }
 
-    memory.Write(address, data);
+    Store<addressingMode>(memory, address, data);
 }
 
-auto CPU::BCC(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BCC(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    if (CF == 0)
-    {
-        PC += data;
-    }
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    BranchIf(_carry == 0, data);
 }
 
-auto CPU::BCS(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BCS(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    if (CF == 1)
-    {
-        PC += data;
-    }
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    BranchIf(_carry != 0, data);
 }
 
-auto CPU::BEQ(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BEQ(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    if (ZF == 1)
-    {
-        PC += data;
-    }
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    BranchIf(_zero == 0, data);
 }
 
-auto CPU::BIT(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BIT(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    ZF = (A & data) == 0;
-    VF = data & 0x40;
-    NF = data & 0x80;
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    _zero = A & data;
+    if constexpr (addressingMode == AddressingMode::Immediate)
+    {
+        return;
+    }
+
+    _overflow = (data & 0x40) != 0;
+    _negative = data;
 }
 
-auto CPU::BMI(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BMI(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    BranchIf(NF == 1, data);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    BranchIf((_negative & 0x80) != 0, data);
 }
 
-auto CPU::BNE(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BNE(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    BranchIf(ZF == 0, data);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    BranchIf(_zero != 0, data);
 }
 
-auto CPU::BPL(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BPL(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    BranchIf(NF == 0, data);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    BranchIf((_negative & 0x80) == 0, data);
 }
 
-auto CPU::BRK(Memory& memory, AddressingMode addressingMode) -> void
+template <Variant variant, AddressingMode addressingMode>
+auto CPU::BRK(Memory& memory, u16 operand) -> void
 {
-    (void)memory;
-    (void)addressingMode;
-    BF = 1;
+    (void)operand;
+    if (_interrupts == nullptr)
+    {
+        BF = 1;
+        return;
+    }
+
+    PC++;
+    Interrupt(memory, IrqVector, 0x30, variant);
 }
 
-auto CPU::BVC(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BVC(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    BranchIf(VF == 0, data);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    BranchIf(_overflow == 0, data);
 }
 
-auto CPU::BVS(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::BVS(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    BranchIf(VF == 1, data);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    BranchIf(_overflow != 0, data);
 }
 
-auto CPU::CLC(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::CLC(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
-    CF = 0;
+    (void)operand;
+    _carry = 0;
 }
 
-auto CPU::CLD(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::CLD(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     DF = 0;
 }
 
-auto CPU::CLI(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::CLI(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     IF = 0;
+    Unmask();
 }
 
-auto CPU::CLV(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::CLV(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
-    VF = 0;
+    (void)operand;
+    _overflow = 0;
 }
 
-auto CPU::CMP(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::CMP(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     Compare(A, data);
 }
 
-auto CPU::CPX(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::CPX(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     Compare(X, data);
 }
 
-auto CPU::CPY(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::CPY(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     Compare(Y, data);
 }
 
-auto CPU::DEC(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::DEC(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
     data--;
-    ZF = data == 0;
-    NF = data & 0x80;
-    memory.Write(address, data);
+    SetResult(data);
+
+    if constexpr (addressingMode == AddressingMode::Accumulator)
+    {
+        A = data;
+        return;
+    }
+
+    Store<addressingMode>(memory, address, data);
 }
 
-auto CPU::DEX(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::DEX(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     X--;
-    ZF = X == 0;
-    NF = X & 0x80;
+    SetResult(X);
 }
 
-auto CPU::DEY(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::DEY(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     Y--;
-    ZF = Y == 0;
-    NF = Y & 0x80;
+    SetResult(Y);
 }
 
-auto CPU::EOR(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::EOR(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     A ^= data;
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
 }
 
-auto CPU::INC(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::INC(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
     data++;
-    ZF = data == 0;
-    NF = data & 0x80;
-    memory.Write(address, data);
+    SetResult(data);
+
+    if constexpr (addressingMode == AddressingMode::Accumulator)
+    {
+        A = data;
+        return;
+    }
+
+    Store<addressingMode>(memory, address, data);
 }
 
-auto CPU::INX(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::INX(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     X++;
-    ZF = X == 0;
-    NF = X & 0x80;
+    SetResult(X);
 }
 
-auto CPU::INY(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::INY(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     Y++;
-    ZF = Y == 0;
-    NF = Y & 0x80;
+    SetResult(Y);
 }
 
-auto CPU::JMP(Memory& memory, AddressingMode addressingMode) -> void
+template <Variant variant, AddressingMode addressingMode>
+auto CPU::JMP(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    PC = address;
+    if constexpr (variant == Variant::Cmos && addressingMode == AddressingMode::Indirect)
+    {
+        PC = memory.Read(operand);
+        PC |= memory.Read(static_cast<u16>(operand + 1)) << 8;
+    }
+    else if constexpr (addressingMode == AddressingMode::Indirect)
+    {
+        PC = memory.Read(operand);
+        PC |= memory.Read((operand & 0xFF00) | static_cast<u8>(operand + 1)) << 8;
+    }
+    else
+    {
+        PC = Address<addressingMode>(memory, operand);
+    }
 }
 
-auto CPU::JSR(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::JSR(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    u16 address = Address<addressingMode>(memory, operand);
+    PC--;
     Push(memory, PC >> 8);
     Push(memory, PC & 0xFF);
     PC = address;
 }
 
-auto CPU::LDA(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::LDA(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     A = data;
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
 }
 
-auto CPU::LDX(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::LDX(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     X = data;
-    ZF = X == 0;
-    NF = X & 0x80;
+    SetResult(X);
 }
 
-auto CPU::LDY(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::LDY(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     Y = data;
-    ZF = Y == 0;
-    NF = Y & 0x80;
+    SetResult(Y);
 }
 
-auto CPU::LSR(Memory& memory, AddressingMode addressingMode) -> void
+template <Variant variant, AddressingMode addressingMode>
+auto CPU::LSR(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    CF = data & 0x01;
+    auto [data, address] = Fetch<addressingMode, variant == Variant::Cmos>(memory, operand);
+    _carry = data & 0x01;
     data >>= 1;
-    ZF = data == 0;
-    NF = data & 0x80;
+    SetResult(data);
 
-    if (addressingMode == AddressingMode::Accumulator)
+    if constexpr (addressingMode == AddressingMode::Accumulator)
     {
         A = data;
         return;
     }
 
-    memory.Write(address, data);
+    Store<addressingMode>(memory, address, data);
 }
 
-auto CPU::NOP(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::NOP(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
+    if constexpr (addressingMode != AddressingMode::Implicit && addressingMode != AddressingMode::Immediate)
+    {
+        Fetch<addressingMode>(memory, operand);
+    }
 }
 
-auto CPU::ORA(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::ORA(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
     A |= data;
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
 }
 
-auto CPU::PHA(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::PHA(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     Push(memory, A);
 }
 
-auto CPU::PHP(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::PHP(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
-    Push(memory, PS);
+    (void)operand;
+    Push(memory, GetStatus() | 0x30);
 }
 
-auto CPU::PLA(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::PLA(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     A = Pop(memory);
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
 }
 
-auto CPU::PLP(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::PLP(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
-    PS = Pop(memory);
+    (void)operand;
+    SetStatus(Pop(memory) & ~0x10);
+    Unmask();
 }
 
-auto CPU::ROL(Memory& memory, AddressingMode addressingMode) -> void
+template <Variant variant, AddressingMode addressingMode>
+auto CPU::ROL(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    u8 oldCF = CF;
-    CF = data & 0x80;
+    auto [data, address] = Fetch<addressingMode, variant == Variant::Cmos>(memory, operand);
+    u8 oldCF = _carry;
+    _carry = (data & 0x80) != 0;
     data <<= 1;
     data |= oldCF;
-    ZF = data == 0;
-    NF = data & 0x80;
+    SetResult(data);
 
-    if (addressingMode == AddressingMode::Accumulator)
+    if constexpr (addressingMode == AddressingMode::Accumulator)
     {
         A = data;
         return;
     }
 
-    memory.Write(address, data);
+    Store<addressingMode>(memory, address, data);
 }
 
-auto CPU::ROR(Memory& memory, AddressingMode addressingMode) -> void
+template <Variant variant, AddressingMode addressingMode>
+auto CPU::ROR(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    u8 oldCF = CF;
-    CF = data & 0x01;
+    auto [data, address] = Fetch<addressingMode, variant == Variant::Cmos>(memory, operand);
+    u8 oldCF = _carry;
+    _carry = data & 0x01;
     data >>= 1;
     data |= oldCF << 7;
-    ZF = data == 0;
-    NF = data & 0x80;
+    SetResult(data);
 
-    if (addressingMode == AddressingMode::Accumulator)
+    if constexpr (addressingMode == AddressingMode::Accumulator)
     {
         A = data;
         return;
     }
 
-    memory.Write(address, data);
+    Store<addressingMode>(memory, address, data);
 }
 
-auto CPU::RTI(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::RTI(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
-    PS = Pop(memory);
+    (void)operand;
+    SetStatus(Pop(memory) & ~0x10);
     PC = Pop(memory);
     PC |= Pop(memory) << 8;
+    Unmask();
 }
 
-auto CPU::RTS(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::RTS(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     PC = Pop(memory);
     PC |= Pop(memory) << 8;
     PC++;
 }
 
-auto CPU::SBC(Memory& memory, AddressingMode addressingMode) -> void
+template <Variant variant, AddressingMode addressingMode>
+auto CPU::SBC(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    u16 result = A - data - (1 - CF);
-    CF = result < 0x100;
-    VF = ((A ^ result) & 0x80) && ((A ^ data) & 0x80);
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    if (DF != 0) [[unlikely]]
+    {
+        if constexpr (variant == Variant::Cmos)
+        {
+            _cycles++;
+        }
+        return DecimalDifference<variant>(data);
+    }
+
+    u16 result = A - data - (1 - _carry);
+    _carry = result < 0x100;
+    _overflow = ((A ^ result) & 0x80) && ((A ^ data) & 0x80);
     A = result;
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
 }
 
-auto CPU::SEC(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::SEC(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
-    CF = 1;
+    (void)operand;
+    _carry = 1;
 }
 
-auto CPU::SED(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::SED(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     DF = 1;
 }
 
-auto CPU::SEI(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::SEI(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     IF = 1;
 }
 
-auto CPU::STA(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::STA(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    memory.Write(address, A);
+    Store<addressingMode>(memory, Address<addressingMode>(memory, operand), A);
 }
 
-auto CPU::STX(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::STX(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    memory.Write(address, X);
+    Store<addressingMode>(memory, Address<addressingMode>(memory, operand), X);
 }
 
-auto CPU::STY(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::STY(Memory& memory, u16 operand) -> void
 {
-    auto [data, address] = Fetch(memory, addressingMode);
-    memory.Write(address, Y);
+    Store<addressingMode>(memory, Address<addressingMode>(memory, operand), Y);
 }
 
-auto CPU::TAX(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::TAX(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     X = A;
-    ZF = X == 0;
-    NF = X & 0x80;
+    SetResult(X);
 }
 
-auto CPU::TAY(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::TAY(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     Y = A;
-    ZF = Y == 0;
-    NF = Y & 0x80;
+    SetResult(Y);
 }
 
-auto CPU::TSX(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::TSX(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     X = SP;
-    ZF = X == 0;
-    NF = X & 0x80;
+    SetResult(X);
 }
 
-auto CPU::TXA(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::TXA(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     A = X;
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
 }
 
-auto CPU::TXS(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::TXS(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     SP = X;
 }
 
-auto CPU::TYA(Memory& memory, AddressingMode addressingMode) -> void
+template <AddressingMode addressingMode>
+auto CPU::TYA(Memory& memory, u16 operand) -> void
 {
     (void)memory;
-    (void)addressingMode;
+    (void)operand;
     A = Y;
-    ZF = A == 0;
-    NF = A & 0x80;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::ALR(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    A &= data;
+    _carry = A & 0x01;
+    A >>= 1;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::ANC(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    A &= data;
+    _carry = A >> 7;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::ANE(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    A = (A | 0xEE) & X & data;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::ARR(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    u8 value = A & data;
+    A = value >> 1 | _carry << 7;
+    SetResult(A);
+
+    if (DF != 0) [[unlikely]]
+    {
+        _overflow = ((value ^ A) & 0x40) != 0;
+        if ((value & 0x0F) + (value & 0x01) > 0x05)
+        {
+            A = (A & 0xF0) | ((A + 0x06) & 0x0F);
+        }
+        _carry = (value & 0xF0) + (value & 0x10) > 0x50;
+        if (_carry != 0)
+        {
+            A += 0x60;
+        }
+        return;
+    }
+
+    _carry = (A >> 6) & 0x01;
+    _overflow = ((A >> 6) ^ (A >> 5)) & 0x01;
+}
+
+template <AddressingMode addressingMode>
+auto CPU::DCP(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
+    data--;
+    Store<addressingMode>(memory, address, data);
+    Compare(A, data);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::ISC(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
+    data++;
+    Store<addressingMode>(memory, address, data);
+    SBC<Variant::Nmos, AddressingMode::Immediate>(memory, data);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::JAM(Memory& memory, u16 operand) -> void
+{
+    (void)memory;
+    (void)operand;
+    PC--;
+    BF = 1;
+    _jammed = true;
+}
+
+template <AddressingMode addressingMode>
+auto CPU::LAS(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    A = X = SP = data & SP;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::LAX(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    A = X = data;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::LXA(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    A = X = (A | 0xEE) & data;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::RLA(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
+    u8 oldCF = _carry;
+    _carry = (data & 0x80) != 0;
+    data = data << 1 | oldCF;
+    Store<addressingMode>(memory, address, data);
+    A &= data;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::RRA(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
+    u8 oldCF = _carry;
+    _carry = data & 0x01;
+    data = data >> 1 | oldCF << 7;
+    Store<addressingMode>(memory, address, data);
+    ADC<Variant::Nmos, AddressingMode::Immediate>(memory, data);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::SAX(Memory& memory, u16 operand) -> void
+{
+    Store<addressingMode>(memory, Address<addressingMode>(memory, operand), A & X);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::SBX(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode>(memory, operand);
+    u16 result = (A & X) - data;
+    _carry = result < 0x100;
+    X = result;
+    SetResult(X);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::SHA(Memory& memory, u16 operand) -> void
+{
+    StoreHigh<addressingMode>(memory, operand, A & X);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::SHX(Memory& memory, u16 operand) -> void
+{
+    StoreHigh<addressingMode>(memory, operand, X);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::SHY(Memory& memory, u16 operand) -> void
+{
+    StoreHigh<addressingMode>(memory, operand, Y);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::SLO(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
+    _carry = (data & 0x80) != 0;
+    data <<= 1;
+    Store<addressingMode>(memory, address, data);
+    A |= data;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::SRE(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
+    _carry = data & 0x01;
+    data >>= 1;
+    Store<addressingMode>(memory, address, data);
+    A ^= data;
+    SetResult(A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::TAS(Memory& memory, u16 operand) -> void
+{
+    SP = A & X;
+    StoreHigh<addressingMode>(memory, operand, SP);
+}
+
+template <u8 bit>
+auto CPU::BBR(Memory& memory, u16 operand) -> void
+{
+    u8 data = ReadZeroPage(memory, operand);
+    BranchIf((data & 1 << bit) == 0, operand >> 8);
+}
+
+template <u8 bit>
+auto CPU::BBS(Memory& memory, u16 operand) -> void
+{
+    u8 data = ReadZeroPage(memory, operand);
+    BranchIf((data & 1 << bit) != 0, operand >> 8);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::BRA(Memory& memory, u16 operand) -> void
+{
+    (void)memory;
+    BranchIf(true, operand);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::PHX(Memory& memory, u16 operand) -> void
+{
+    (void)operand;
+    Push(memory, X);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::PHY(Memory& memory, u16 operand) -> void
+{
+    (void)operand;
+    Push(memory, Y);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::PLX(Memory& memory, u16 operand) -> void
+{
+    (void)operand;
+    X = Pop(memory);
+    SetResult(X);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::PLY(Memory& memory, u16 operand) -> void
+{
+    (void)operand;
+    Y = Pop(memory);
+    SetResult(Y);
+}
+
+template <u8 bit>
+auto CPU::RMB(Memory& memory, u16 operand) -> void
+{
+    WriteZeroPage(memory, operand, ReadZeroPage(memory, operand) & ~(1 << bit));
+}
+
+template <u8 bit>
+auto CPU::SMB(Memory& memory, u16 operand) -> void
+{
+    WriteZeroPage(memory, operand, ReadZeroPage(memory, operand) | 1 << bit);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::STP(Memory& memory, u16 operand) -> void
+{
+    (void)memory;
+    (void)operand;
+    PC--;
+    BF = 1;
+}
+
+template <AddressingMode addressingMode>
+auto CPU::STZ(Memory& memory, u16 operand) -> void
+{
+    Store<addressingMode>(memory, Address<addressingMode>(memory, operand), 0);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::TRB(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
+    _zero = A & data;
+    Store<addressingMode>(memory, address, data & ~A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::TSB(Memory& memory, u16 operand) -> void
+{
+    auto [data, address] = Fetch<addressingMode, false>(memory, operand);
+    _zero = A & data;
+    Store<addressingMode>(memory, address, data | A);
+}
+
+template <AddressingMode addressingMode>
+auto CPU::WAI(Memory& memory, u16 operand) -> void
+{
+    (void)memory;
+    (void)operand;
+    if (_interrupts == nullptr)
+    {
+        PC--;
+        BF = 1;
+    }
+    else if (_interrupts->_irq == 0 && !_interrupts->_nmi)
+    {
+        PC--;
+    }
 }
@@ -0,0 +1,18 @@
+#include <device.hh>
+
+CallbackDevice::CallbackDevice(ReadCallback read, WriteCallback write) : _read(std::move(read)), _write(std::move(write))
+{
+}
+
+auto CallbackDevice::Read(u16 address) -> u8
+{
+    return _read != nullptr ? _read(address) : 0x00;
+}
+
+auto CallbackDevice::Write(u16 address, u8 data) -> void
+{
+    if (_write != nullptr)
+    {
+        _write(address, data);
+    }
+}
@@ -0,0 +1,80 @@
+#include <disassembler.hh>
+#include <cstdio>
+
+auto Disassembler::Disassemble(u16 address, u8 opcode, u16 operand, Variant variant) -> std::string
+{
+    Instruction instruction = GetInstructions(variant)[opcode];
+    std::string text(Mnemonic(instruction.operation));
+    switch (instruction.operation)
+    {
+        case Operation::BBR:
+        case Operation::BBS:
+        case Operation::RMB:
+        case Operation::SMB:
+            text += static_cast<char>('0' + ((opcode >> 4) & 0x07));
+            break;
+        default:
+            break;
+    }
+
+    char buffer[16];
+    switch (instruction.addressingMode)
+    {
+        case AddressingMode::Implicit:
+            return text;
+        case AddressingMode::Accumulator:
+            return text + " A";
+        case AddressingMode::Immediate:
+            std::snprintf(buffer, sizeof(buffer), " #$%02X", operand & 0xFF);
+            break;
+        case AddressingMode::ZeroPage:
+            std::snprintf(buffer, sizeof(buffer), " $%02X", operand & 0xFF);
+            break;
+        case AddressingMode::ZeroPageX:
+            std::snprintf(buffer, sizeof(buffer), " $%02X,X", operand & 0xFF);
+            break;
+        case AddressingMode::ZeroPageY:
+            std::snprintf(buffer, sizeof(buffer), " $%02X,Y", operand & 0xFF);
+            break;
+        case AddressingMode::Relative:
+            std::snprintf(buffer, sizeof(buffer), " $%04X", static_cast<u16>(address + 2 + static_cast<signed char>(operand & 0xFF)));
+            break;
+        case AddressingMode::Absolute:
+            std::snprintf(buffer, sizeof(buffer), " $%04X", operand);
+            break;
+        case AddressingMode::AbsoluteX:
+            std::snprintf(buffer, sizeof(buffer), " $%04X,X", operand);
+            break;
+        case AddressingMode::AbsoluteY:
+            std::snprintf(buffer, sizeof(buffer), " $%04X,Y", operand);
+            break;
+        case AddressingMode::Indirect:
+            std::snprintf(buffer, sizeof(buffer), " ($%04X)", operand);
+            break;
+        case AddressingMode::IndirectX:
+            std::snprintf(buffer, sizeof(buffer), " ($%02X,X)", operand & 0xFF);
+            break;
+        case AddressingMode::IndirectY:
+            std::snprintf(buffer, sizeof(buffer), " ($%02X),Y", operand & 0xFF);
+            break;
+        case AddressingMode::ZeroPageIndirect:
+            std::snprintf(buffer, sizeof(buffer), " ($%02X)", operand & 0xFF);
+            break;
+        case AddressingMode::AbsoluteIndexedIndirect:
+            std::snprintf(buffer, sizeof(buffer), " ($%04X,X)", operand);
+            break;
+        case AddressingMode::ZeroPageRelative:
+            std::snprintf(buffer, sizeof(buffer), " $%02X,$%04X", operand & 0xFF, static_cast<u16>(address + 3 + static_cast<signed char>(operand >> 8)));
+            break;
+    }
+    return text + buffer;
+}
+
+auto Disassembler::Disassemble(const Memory& memory, u16 address, Variant variant) -> std::string
+{
+    u8 opcode = memory.Read(address);
+    u8 length = Length(GetInstructions(variant)[opcode].addressingMode);
+    u16 operand = length > 1 ? memory.Read(address + 1) : 0;
+    operand |= length > 2 ? memory.Read(address + 2) << 8 : 0;
+    return Disassemble(address, opcode, operand, variant);
+}
@@ -0,0 +1,40 @@
+#include <fork.hh>
+
+Fork::Fork(const CPU& cpu, Memory& memory) : _registers(cpu.GetRegisters()), _cycles(cpu.GetCycles()), _pages(std::make_shared<const Memory::Pages>(memory.Capture()))
+{
+}
+
+auto Fork::Spawn() const -> std::unique_ptr<Machine>
+{
+    auto machine = std::make_unique<Machine>();
+    Spawn(machine->cpu, machine->memory);
+    return machine;
+}
+
+auto Fork::Spawn(u32 count) const -> std::vector<std::unique_ptr<Machine>>
+{
+    std::vector<std::unique_ptr<Machine>> machines;
+    machines.reserve(count);
+    for (u32 index = 0; index < count; index++)
+    {
+        machines.push_back(Spawn());
+    }
+    return machines;
+}
+
+auto Fork::Spawn(CPU& cpu, Memory& memory) const -> void
+{
+    cpu.SetRegisters(_registers);
+    cpu.SetCycles(_cycles);
+    memory.Inherit(_pages);
+}
+
+auto Fork::GetRegisters() const -> Registers
+{
+    return _registers;
+}
+
+auto Fork::GetCycles() const -> u64
+{
+    return _cycles;
+}
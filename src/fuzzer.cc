@@ -0,0 +1,343 @@
+#include <fuzzer.hh>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+static constexpr u32 Rounds = 64;
+static constexpr u32 MaxStack = 16;
+
+static constexpr u8 Interesting8[] = { 0x00, 0x01, 0x10, 0x20, 0x40, 0x7F, 0x80, 0xFF };
+static constexpr u16 Interesting16[] = { 0x0000, 0x0080, 0x00FF, 0x0100, 0x7FFF, 0x8000, 0xFFFF };
+
+struct Fuzzer::Worker
+{
+    Machine machine;
+    Coverage coverage;
+    Counters* counters;
+    u64 state;
+
+    auto Next() -> u64
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1D;
+    }
+
+    auto Below(u64 limit) -> u64
+    {
+        return (Next() >> 32) * limit >> 32;
+    }
+};
+
+static auto Mix(u64 value) -> u64
+{
+    value += 0x9E3779B97F4A7C15;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+Fuzzer::Fuzzer(const CPU& cpu, Memory& memory, std::vector<FuzzRegion> regions, const FuzzOptions& options) : _fork(cpu, memory), _regions(std::move(regions)), _options(options), _size(0), _seen(std::make_unique<std::atomic<u8>[]>(Coverage::MapSize)), _edges(0), _calibrated(0), _elapsed(0), _running(false), _pool(options.threads), _stopping(false)
+{
+    for (const FuzzRegion& region : _regions)
+    {
+        if (region.size == 0 || region.address + region.size > 0x10000)
+        {
+            throw std::runtime_error("fuzz region out of range");
+        }
+        _size += region.size;
+    }
+
+    if (_size == 0)
+    {
+        throw std::runtime_error("fuzzer needs at least one input region");
+    }
+
+    if (_options.seed == 0)
+    {
+        _options.seed = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    _counters = std::make_unique<Counters[]>(_pool.GetThreadCount());
+}
+
+auto Fuzzer::AddSeed(std::span<const u8> input) -> void
+{
+    std::vector<u8> seed(_size);
+    std::copy_n(input.begin(), std::min<u64>(input.size(), _size), seed.begin());
+
+    std::lock_guard lock(_mutex);
+    _corpus.push_back(std::move(seed));
+}
+
+auto Fuzzer::Run(std::chrono::milliseconds duration, const Report& report, std::chrono::milliseconds interval) -> FuzzStatistics
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard lock(_mutex);
+        if (_corpus.empty())
+        {
+            _corpus.emplace_back(_size);
+        }
+        _start = start;
+        _running = true;
+    }
+
+    _stopping = false;
+    for (u32 index = 0; index < _pool.GetThreadCount(); index++)
+    {
+        _pool.Submit([this, index] { Fuzz(index); });
+    }
+
+    std::chrono::steady_clock::time_point deadline = start + duration;
+    while (!_stopping)
+    {
+        std::chrono::steady_clock::duration wait = interval;
+        if (duration.count() != 0)
+        {
+            wait = std::min(wait, deadline - std::chrono::steady_clock::now());
+        }
+        if (wait.count() > 0)
+        {
+            std::this_thread::sleep_for(wait);
+        }
+
+        if (duration.count() != 0 && std::chrono::steady_clock::now() >= deadline)
+        {
+            break;
+        }
+
+        if (report)
+        {
+            report(GetStatistics());
+        }
+    }
+
+    _stopping = true;
+    _pool.Wait();
+    {
+        std::lock_guard lock(_mutex);
+        _elapsed += std::chrono::steady_clock::now() - _start;
+        _running = false;
+    }
+    return GetStatistics();
+}
+
+auto Fuzzer::Stop() -> void
+{
+    _stopping = true;
+}
+
+auto Fuzzer::GetStatistics() const -> FuzzStatistics
+{
+    FuzzStatistics statistics = {};
+    for (u32 index = 0; index < _pool.GetThreadCount(); index++)
+    {
+        statistics.executions += _counters[index].executions.load(std::memory_order_relaxed);
+        statistics.timeouts += _counters[index].timeouts.load(std::memory_order_relaxed);
+    }
+    statistics.edges = _edges.load(std::memory_order_relaxed);
+
+    std::lock_guard lock(_mutex);
+    statistics.corpus = _corpus.size();
+    statistics.findings = _findings.size();
+    std::chrono::steady_clock::duration elapsed = _elapsed;
+    if (_running)
+    {
+        elapsed += std::chrono::steady_clock::now() - _start;
+    }
+    statistics.seconds = std::chrono::duration<double>(elapsed).count();
+    return statistics;
+}
+
+auto Fuzzer::GetCorpus() const -> std::vector<std::vector<u8>>
+{
+    std::lock_guard lock(_mutex);
+    return _corpus;
+}
+
+auto Fuzzer::GetFindings() const -> std::vector<FuzzFinding>
+{
+    std::lock_guard lock(_mutex);
+    std::vector<FuzzFinding> findings;
+    for (const auto& [key, input] : _findings)
+    {
+        findings.push_back({ input, key.first, key.second });
+    }
+    return findings;
+}
+
+auto Fuzzer::GetInputSize() const -> u32
+{
+    return _size;
+}
+
+auto Fuzzer::GetThreadCount() const -> u32
+{
+    return _pool.GetThreadCount();
+}
+
+auto Fuzzer::Fuzz(u32 index) -> void
+{
+    auto worker = std::make_unique<Worker>();
+    worker->counters = &_counters[index];
+    worker->state = Mix(_options.seed + index) | 1;
+
+    std::vector<u8> parent;
+    std::vector<u8> other;
+    std::vector<u8> input;
+    while (!_stopping.load(std::memory_order_relaxed))
+    {
+        bool calibrating = false;
+        {
+            std::lock_guard lock(_mutex);
+            if (_calibrated < _corpus.size())
+            {
+                parent = _corpus[_calibrated++];
+                calibrating = true;
+            }
+            else
+            {
+                parent = _corpus[worker->Below(_corpus.size())];
+                other = _corpus[worker->Below(_corpus.size())];
+            }
+        }
+
+        if (calibrating)
+        {
+            Execute(*worker, parent);
+            continue;
+        }
+
+        for (u32 round = 0; round < Rounds && !_stopping.load(std::memory_order_relaxed); round++)
+        {
+            input = parent;
+            Mutate(*worker, input, other);
+            if (Execute(*worker, input))
+            {
+                std::lock_guard lock(_mutex);
+                _corpus.push_back(input);
+            }
+        }
+    }
+}
+
+auto Fuzzer::Execute(Worker& worker, std::span<const u8> input) -> bool
+{
+    CPU& cpu = worker.machine.cpu;
+    Memory& memory = worker.machine.memory;
+    _fork.Spawn(cpu, memory);
+
+    u32 offset = 0;
+    for (const FuzzRegion& region : _regions)
+    {
+        for (u32 index = 0; index < region.size; index++)
+        {
+            memory.Write(region.address + index, input[offset++]);
+        }
+    }
+
+    worker.coverage.Clear();
+    RunResult result;
+    switch (_options.variant)
+    {
+        case Variant::Cmos:
+            result = cpu.RunFor<Variant::Cmos>(memory, _options.instructions, std::numeric_limits<u64>::max(), worker.coverage);
+            break;
+        case Variant::Strict:
+            result = cpu.RunFor<Variant::Strict>(memory, _options.instructions, std::numeric_limits<u64>::max(), worker.coverage);
+            break;
+        default:
+            result = cpu.RunFor<Variant::Nmos>(memory, _options.instructions, std::numeric_limits<u64>::max(), worker.coverage);
+            break;
+    }
+
+    worker.counters->executions.fetch_add(1, std::memory_order_relaxed);
+    if (result.reason == StopReason::InstructionLimit || result.reason == StopReason::CycleLimit)
+    {
+        worker.counters->timeouts.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool novel = Evaluate(worker.coverage);
+    if (result.reason == StopReason::IllegalOpcode)
+    {
+        std::lock_guard lock(_mutex);
+        _findings.try_emplace({ result.reason, cpu.GetRegisters().PC }, input.begin(), input.end());
+        return false;
+    }
+    return novel;
+}
+
+auto Fuzzer::Evaluate(const Coverage& coverage) -> bool
+{
+    bool novel = false;
+    for (u16 edge : coverage.GetEdges())
+    {
+        u8 bucket = Coverage::Bucket(coverage.GetCount(edge));
+        if ((_seen[edge].load(std::memory_order_relaxed) & bucket) == 0) [[unlikely]]
+        {
+            u8 previous = _seen[edge].fetch_or(bucket, std::memory_order_relaxed);
+            if ((previous & bucket) == 0)
+            {
+                novel = true;
+                if (previous == 0)
+                {
+                    _edges.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+    return novel;
+}
+
+auto Fuzzer::Mutate(Worker& worker, std::vector<u8>& input, std::span<const u8> other) -> void
+{
+    u64 size = input.size();
+    u32 stack = 1 << worker.Below(std::bit_width(MaxStack));
+    for (u32 count = 0; count < stack; count++)
+    {
+        u64 position = worker.Below(size);
+        u64 length = worker.Below(size - position) + 1;
+        switch (worker.Below(other.empty() ? 7 : 8))
+        {
+            case 0:
+                input[position] ^= 1 << worker.Below(8);
+                break;
+            case 1:
+                input[position] = worker.Next();
+                break;
+            case 2:
+                input[position] = Interesting8[worker.Below(std::size(Interesting8))];
+                break;
+            case 3:
+                input[position] += worker.Below(2) != 0 ? worker.Below(35) + 1 : -(worker.Below(35) + 1);
+                break;
+            case 4:
+            {
+                u16 value = Interesting16[worker.Below(std::size(Interesting16))];
+                input[position] = value & 0xFF;
+                if (position + 1 < size)
+                {
+                    input[position + 1] = value >> 8;
+                }
+                break;
+            }
+            case 5:
+            {
+                u64 source = worker.Below(size - length + 1);
+                std::memmove(&input[position], &input[source], length);
+                break;
+            }
+            case 6:
+                std::fill_n(input.begin() + position, length, worker.Below(2) != 0 ? input[worker.Below(size)] : static_cast<u8>(worker.Next()));
+                break;
+            default:
+                std::copy_n(other.begin() + position, length, input.begin() + position);
+                break;
+        }
+    }
+}
@@ -0,0 +1,672 @@
+#include <gdbserver.hh>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define CPU6502_SOCKETS 1
+#else
+#define CPU6502_SOCKETS 0
+#endif
+
+#if CPU6502_SOCKETS && !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+
+static constexpr std::string_view TargetDescription = R"(<?xml version="1.0"?>
+<!DOCTYPE target SYSTEM "gdb-target.dtd">
+<target version="1.0">
+  <feature name="org.cpu6502.core">
+    <reg name="a" bitsize="8" type="uint8" regnum="0"/>
+    <reg name="x" bitsize="8" type="uint8"/>
+    <reg name="y" bitsize="8" type="uint8"/>
+    <reg name="p" bitsize="8" type="uint8"/>
+    <reg name="sp" bitsize="8" type="uint8"/>
+    <reg name="pc" bitsize="16" type="code_ptr"/>
+  </feature>
+</target>
+)";
+
+static constexpr u32 RegisterCount = 6;
+
+static auto Hex(u64 value, u32 digits) -> std::string
+{
+    std::string text(digits, '0');
+    for (u32 index = digits; index-- > 0; value >>= 4)
+    {
+        text[index] = "0123456789abcdef"[value & 0x0F];
+    }
+    return text;
+}
+
+static auto ParseHex(std::string_view text) -> u64
+{
+    u64 value = 0;
+    for (char c : text)
+    {
+        u8 digit = c >= 'a' ? c - 'a' + 10 : c >= 'A' ? c - 'A' + 10 : c - '0';
+        if (digit > 0x0F)
+        {
+            throw std::runtime_error("invalid hex number");
+        }
+        value = value << 4 | digit;
+    }
+    return value;
+}
+
+static auto Split(std::string_view text, char separator) -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> fields;
+    for (u64 start = 0;;)
+    {
+        u64 end = text.find(separator, start);
+        fields.push_back(text.substr(start, end - start));
+        if (end == std::string_view::npos)
+        {
+            return fields;
+        }
+        start = end + 1;
+    }
+}
+
+static auto Escape(std::string_view data) -> std::string
+{
+    std::string escaped;
+    for (char c : data)
+    {
+        if (c == '#' || c == '$' || c == '}' || c == '*')
+        {
+            escaped += '}';
+            c ^= 0x20;
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+static auto GetRegister(const Registers& registers, u32 index) -> std::string
+{
+    switch (index)
+    {
+        case 0:
+            return Hex(registers.A, 2);
+        case 1:
+            return Hex(registers.X, 2);
+        case 2:
+            return Hex(registers.Y, 2);
+        case 3:
+            return Hex(registers.PS, 2);
+        case 4:
+            return Hex(registers.SP, 2);
+        default:
+            return Hex(registers.PC & 0xFF, 2) + Hex(registers.PC >> 8, 2);
+    }
+}
+
+static auto SetRegister(Registers& registers, u32 index, std::string_view value) -> void
+{
+    switch (index)
+    {
+        case 0:
+            registers.A = ParseHex(value.substr(0, 2));
+            break;
+        case 1:
+            registers.X = ParseHex(value.substr(0, 2));
+            break;
+        case 2:
+            registers.Y = ParseHex(value.substr(0, 2));
+            break;
+        case 3:
+            registers.PS = ParseHex(value.substr(0, 2)) & ~0x10;
+            break;
+        case 4:
+            registers.SP = ParseHex(value.substr(0, 2));
+            break;
+        default:
+            registers.PC = ParseHex(value.substr(0, 2)) | ParseHex(value.substr(2, 2)) << 8;
+            break;
+    }
+}
+
+GdbServer::GdbServer(CPU& cpu, Memory& memory, Variant variant) : _cpu(cpu), _memory(memory), _timeline(cpu, memory, variant), _listener(-1), _connection(-1), _stop("S05"), _acknowledge(true), _attached(false)
+{
+}
+
+GdbServer::~GdbServer()
+{
+    Close();
+#if CPU6502_SOCKETS
+    if (_listener >= 0)
+    {
+        close(_listener);
+    }
+    if (!_path.empty())
+    {
+        unlink(_path.c_str());
+    }
+#endif
+}
+
+auto GdbServer::Listen(const std::string& address) -> void
+{
+#if CPU6502_SOCKETS
+    u64 separator = address.rfind(':');
+    if (separator == std::string::npos)
+    {
+        struct stat status;
+        if (stat(address.c_str(), &status) == 0 && S_ISSOCK(status.st_mode))
+        {
+            unlink(address.c_str());
+        }
+
+        sockaddr_un local = {};
+        local.sun_family = AF_UNIX;
+        if (address.size() >= sizeof(local.sun_path))
+        {
+            throw std::runtime_error("socket path too long: " + address);
+        }
+        std::strcpy(local.sun_path, address.c_str());
+
+        _listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (_listener < 0 || bind(_listener, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 || listen(_listener, 1) != 0)
+        {
+            throw std::runtime_error("cannot listen on " + address);
+        }
+        _path = address;
+        return;
+    }
+
+    std::string host = separator != 0 ? address.substr(0, separator) : "127.0.0.1";
+    std::string port = address.substr(separator + 1);
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+    {
+        throw std::runtime_error("cannot resolve " + address);
+    }
+
+    for (addrinfo* candidate = addresses; candidate != nullptr && _listener < 0; candidate = candidate->ai_next)
+    {
+        _listener = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        if (_listener < 0)
+        {
+            continue;
+        }
+
+        int reuse = 1;
+        setsockopt(_listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(_listener, candidate->ai_addr, candidate->ai_addrlen) != 0 || listen(_listener, 1) != 0)
+        {
+            close(_listener);
+            _listener = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+
+    if (_listener < 0)
+    {
+        throw std::runtime_error("cannot listen on " + address);
+    }
+#else
+    (void)address;
+    throw std::runtime_error("the GDB server is not supported on this platform");
+#endif
+}
+
+auto GdbServer::Serve() -> void
+{
+#if CPU6502_SOCKETS
+    if (_listener < 0)
+    {
+        throw std::runtime_error("the GDB server is not listening");
+    }
+
+    _connection = accept(_listener, nullptr, nullptr);
+    if (_connection < 0)
+    {
+        throw std::runtime_error("cannot accept a debugger connection");
+    }
+
+    int delay = 1;
+    setsockopt(_connection, IPPROTO_TCP, TCP_NODELAY, &delay, sizeof(delay));
+    _input.clear();
+    _acknowledge = true;
+    _attached = true;
+
+    while (_attached)
+    {
+        std::optional<std::string> packet = Receive();
+        if (!packet.has_value())
+        {
+            break;
+        }
+
+        std::optional<std::string> reply;
+        try
+        {
+            reply = Handle(*packet);
+        }
+        catch (const std::exception&)
+        {
+            reply = "E01";
+        }
+
+        if (reply.has_value())
+        {
+            Send(*reply);
+        }
+        if (*packet == "QStartNoAckMode")
+        {
+            _acknowledge = false;
+        }
+    }
+
+    Close();
+#endif
+}
+
+auto GdbServer::Receive() -> std::optional<std::string>
+{
+    while (true)
+    {
+        int c = ReadByte();
+        if (c < 0)
+        {
+            return std::nullopt;
+        }
+        if (c == 0x03)
+        {
+            return std::string(1, 0x03);
+        }
+        if (c == '-' && !_last.empty())
+        {
+            Send(_last);
+            continue;
+        }
+        if (c != '$')
+        {
+            continue;
+        }
+
+        std::string data;
+        for (c = ReadByte(); c >= 0 && c != '#'; c = ReadByte())
+        {
+            data += static_cast<char>(c);
+        }
+
+        int high = ReadByte();
+        int low = ReadByte();
+        if (high < 0 || low < 0)
+        {
+            return std::nullopt;
+        }
+
+        u8 checksum = 0;
+        for (char d : data)
+        {
+            checksum += d;
+        }
+
+        bool valid = std::isxdigit(high) && std::isxdigit(low) && ParseHex(std::string{ static_cast<char>(high), static_cast<char>(low) }) == checksum;
+        if (_acknowledge)
+        {
+#if CPU6502_SOCKETS
+            ::send(_connection, valid ? "+" : "-", 1, MSG_NOSIGNAL);
+#endif
+        }
+        if (valid)
+        {
+            return data;
+        }
+    }
+}
+
+auto GdbServer::Send(std::string_view data) -> void
+{
+    u8 checksum = 0;
+    for (char c : data)
+    {
+        checksum += c;
+    }
+
+    _last = data;
+    std::string packet(1, '$');
+    packet += data;
+    packet += '#';
+    packet += Hex(checksum, 2);
+#if CPU6502_SOCKETS
+    for (u64 sent = 0; sent < packet.size();)
+    {
+        ssize_t count = ::send(_connection, packet.data() + sent, packet.size() - sent, MSG_NOSIGNAL);
+        if (count <= 0)
+        {
+            _attached = false;
+            return;
+        }
+        sent += count;
+    }
+#endif
+}
+
+auto GdbServer::ReadByte() -> int
+{
+    if (!_input.empty())
+    {
+        u8 c = _input.front();
+        _input.erase(0, 1);
+        return c;
+    }
+
+#if CPU6502_SOCKETS
+    u8 c;
+    if (recv(_connection, &c, 1, 0) == 1)
+    {
+        return c;
+    }
+#endif
+    return -1;
+}
+
+auto GdbServer::Interrupted() -> bool
+{
+#if CPU6502_SOCKETS
+    pollfd descriptor = { _connection, POLLIN, 0 };
+    while (poll(&descriptor, 1, 0) > 0 && (descriptor.revents & POLLIN) != 0)
+    {
+        char buffer[256];
+        ssize_t count = recv(_connection, buffer, sizeof(buffer), 0);
+        if (count <= 0)
+        {
+            return true;
+        }
+        _input.append(buffer, count);
+    }
+#endif
+
+    u64 position = _input.find('\x03');
+    if (position == std::string::npos)
+    {
+        return false;
+    }
+    _input.erase(position, 1);
+    return true;
+}
+
+auto GdbServer::Close() -> void
+{
+#if CPU6502_SOCKETS
+    if (_connection >= 0)
+    {
+        close(_connection);
+        _connection = -1;
+    }
+#endif
+    _attached = false;
+}
+
+auto GdbServer::Handle(const std::string& packet) -> std::optional<std::string>
+{
+    if (packet.empty())
+    {
+        return "";
+    }
+
+    switch (packet[0])
+    {
+        case 0x03:
+            return _stop = "S02";
+        case '?':
+            return _stop;
+        case 'g':
+        {
+            Registers registers = _cpu.GetRegisters();
+            std::string reply;
+            for (u32 index = 0; index < RegisterCount; index++)
+            {
+                reply += GetRegister(registers, index);
+            }
+            return reply;
+        }
+        case 'G':
+        {
+            Registers registers = _cpu.GetRegisters();
+            std::string_view values = std::string_view(packet).substr(1);
+            for (u32 index = 0, offset = 0; index < RegisterCount && offset < values.size(); offset += index == RegisterCount - 1 ? 4 : 2, index++)
+            {
+                SetRegister(registers, index, values.substr(offset));
+            }
+            _cpu.SetRegisters(registers);
+            _timeline.Commit();
+            return "OK";
+        }
+        case 'p':
+        {
+            u32 index = ParseHex(std::string_view(packet).substr(1));
+            return index < RegisterCount ? GetRegister(_cpu.GetRegisters(), index) : "E00";
+        }
+        case 'P':
+        {
+            std::vector<std::string_view> fields = Split(std::string_view(packet).substr(1), '=');
+            u32 index = ParseHex(fields.at(0));
+            if (index >= RegisterCount)
+            {
+                return "E00";
+            }
+            Registers registers = _cpu.GetRegisters();
+            SetRegister(registers, index, fields.at(1));
+            _cpu.SetRegisters(registers);
+            _timeline.Commit();
+            return "OK";
+        }
+        case 'm':
+        {
+            std::vector<std::string_view> fields = Split(std::string_view(packet).substr(1), ',');
+            u64 address = ParseHex(fields.at(0));
+            u64 length = ParseHex(fields.at(1));
+            std::string reply;
+            for (u64 offset = 0; offset < length && address + offset < 0x10000; offset++)
+            {
+                reply += Hex(_memory.Read(address + offset), 2);
+            }
+            return reply.empty() && length != 0 ? "E01" : reply;
+        }
+        case 'M':
+        {
+            std::vector<std::string_view> fields = Split(std::string_view(packet).substr(1), ':');
+            std::vector<std::string_view> range = Split(fields.at(0), ',');
+            u64 address = ParseHex(range.at(0));
+            u64 length = ParseHex(range.at(1));
+            std::string_view data = fields.at(1);
+            if (address + length > 0x10000 || data.size() < length * 2)
+            {
+                return "E01";
+            }
+            for (u64 offset = 0; offset < length; offset++)
+            {
+                _memory.Write(address + offset, ParseHex(data.substr(offset * 2, 2)));
+            }
+            _timeline.Commit();
+            return "OK";
+        }
+        case 'c':
+        case 's':
+        {
+            if (packet.size() > 1)
+            {
+                Registers registers = _cpu.GetRegisters();
+                registers.PC = ParseHex(std::string_view(packet).substr(1));
+                _cpu.SetRegisters(registers);
+                _timeline.Commit();
+            }
+            return _stop = Resume(packet[0] == 's');
+        }
+        case 'b':
+            if (packet == "bs" || packet == "bc")
+            {
+                return _stop = Reverse(packet == "bs");
+            }
+            return "";
+        case 'Z':
+        case 'z':
+            return Insert(packet, packet[0] == 'Z');
+        case 'H':
+        case 'T':
+            return "OK";
+        case 'D':
+            Send("OK");
+            Close();
+            return std::nullopt;
+        case 'k':
+            Close();
+            return std::nullopt;
+        case 'q':
+        case 'Q':
+            return Query(packet);
+        default:
+            return "";
+    }
+}
+
+auto GdbServer::Query(const std::string& packet) -> std::string
+{
+    if (packet.starts_with("qSupported"))
+    {
+        return "PacketSize=4000;qXfer:features:read+;QStartNoAckMode+;ReverseStep+;ReverseContinue+";
+    }
+    if (packet == "QStartNoAckMode")
+    {
+        return "OK";
+    }
+    if (packet == "qAttached")
+    {
+        return "1";
+    }
+    if (packet == "qC")
+    {
+        return "QC1";
+    }
+    if (packet == "qfThreadInfo")
+    {
+        return "m1";
+    }
+    if (packet == "qsThreadInfo")
+    {
+        return "l";
+    }
+    if (packet.starts_with("qSymbol"))
+    {
+        return "OK";
+    }
+
+    constexpr std::string_view features = "qXfer:features:read:target.xml:";
+    if (packet.starts_with(features))
+    {
+        std::vector<std::string_view> fields = Split(std::string_view(packet).substr(features.size()), ',');
+        u64 offset = ParseHex(fields.at(0));
+        u64 length = ParseHex(fields.at(1));
+        if (offset >= TargetDescription.size())
+        {
+            return "l";
+        }
+        std::string_view chunk = TargetDescription.substr(offset, length);
+        std::string reply(1, offset + chunk.size() < TargetDescription.size() ? 'm' : 'l');
+        reply += Escape(chunk);
+        return reply;
+    }
+    return "";
+}
+
+auto GdbServer::Resume(bool step) -> std::string
+{
+    if (step)
+    {
+        return Report(_timeline.Run(1, std::numeric_limits<u64>::max(), _breakpoints));
+    }
+
+    while (true)
+    {
+        RunResult result = _timeline.Run(Slice, std::numeric_limits<u64>::max(), _breakpoints);
+        if (result.reason != StopReason::InstructionLimit)
+        {
+            return Report(result);
+        }
+        if (Interrupted())
+        {
+            return "S02";
+        }
+        if (_breakpoints.IsSet(_cpu.GetRegisters().PC))
+        {
+            return Report({ StopReason::Breakpoint, 0, 0 });
+        }
+    }
+}
+
+auto GdbServer::Reverse(bool step) -> std::string
+{
+    bool moved = step ? _timeline.ReverseStep() : _timeline.ReverseContinue(_breakpoints);
+    return moved ? "S05" : "T05replaylog:begin;";
+}
+
+auto GdbServer::Report(const RunResult& result) -> std::string
+{
+    switch (result.reason)
+    {
+        case StopReason::Break:
+            return "W00";
+        case StopReason::IllegalOpcode:
+            return "S04";
+        case StopReason::Watchpoint:
+        {
+            u16 address = *_breakpoints.GetWatchHit();
+            const char* kind = _breakpoints.IsWatched(address, Access::Read) && _breakpoints.IsWatched(address, Access::Write) ? "awatch" : _breakpoints.GetWatchAccess() == Access::Read ? "rwatch" : "watch";
+            return "T05" + std::string(kind) + ":" + Hex(address, 4) + ";";
+        }
+        default:
+            return "S05";
+    }
+}
+
+auto GdbServer::Insert(const std::string& packet, bool insert) -> std::string
+{
+    std::vector<std::string_view> fields = Split(std::string_view(packet).substr(1), ',');
+    u64 type = ParseHex(fields.at(0));
+    u64 address = ParseHex(fields.at(1));
+    u64 length = fields.size() > 2 ? ParseHex(Split(fields[2], ';')[0]) : 1;
+    if (address >= 0x10000)
+    {
+        return "E01";
+    }
+
+    if (type <= 1)
+    {
+        insert ? _breakpoints.Set(address) : _breakpoints.Remove(address);
+        return "OK";
+    }
+
+    if (type > 4)
+    {
+        return "";
+    }
+
+    Access access = type == 2 ? Access::Write : type == 3 ? Access::Read : Access::ReadWrite;
+    for (u64 offset = 0; offset < std::max<u64>(length, 1) && address + offset < 0x10000; offset++)
+    {
+        insert ? _breakpoints.Watch(address + offset, access) : _breakpoints.Unwatch(address + offset, access);
+    }
+    return "OK";
+}
@@ -0,0 +1,104 @@
+#include <interrupt.hh>
+#include <algorithm>
+#include <stdexcept>
+
+auto InterruptController::Reset() -> void
+{
+    _events.clear();
+    _irq = 0;
+    _nmiLine = false;
+    _nmi = false;
+    _masked = false;
+    Update();
+}
+
+auto InterruptController::Schedule(u64 cycle, Callback callback) -> EventId
+{
+    EventId id = _next++;
+    _events.push_back({ cycle, id, std::move(callback) });
+    std::push_heap(_events.begin(), _events.end(), Later);
+    Update();
+    return id;
+}
+
+auto InterruptController::Cancel(EventId id) -> bool
+{
+    auto event = std::find_if(_events.begin(), _events.end(), [id](const Event& event) { return event.id == id; });
+    if (event == _events.end())
+    {
+        return false;
+    }
+
+    _events.erase(event);
+    std::make_heap(_events.begin(), _events.end(), Later);
+    Update();
+    return true;
+}
+
+auto InterruptController::GetEventCount() const -> u64
+{
+    return _events.size();
+}
+
+auto InterruptController::SetIrq(u32 source, bool asserted) -> void
+{
+    if (source >= IrqSourceCount)
+    {
+        throw std::out_of_range("invalid IRQ source");
+    }
+
+    if (asserted)
+    {
+        _irq |= 1u << source;
+    }
+    else
+    {
+        _irq &= ~(1u << source);
+    }
+    Update();
+}
+
+auto InterruptController::SetNmi(bool asserted) -> void
+{
+    if (asserted && !_nmiLine)
+    {
+        _nmi = true;
+    }
+    _nmiLine = asserted;
+    Update();
+}
+
+auto InterruptController::TriggerNmi() -> void
+{
+    _nmi = true;
+    Update();
+}
+
+auto InterruptController::Dispatch(u64 cycle) -> void
+{
+    while (!_events.empty() && _events.front().cycle <= cycle)
+    {
+        std::pop_heap(_events.begin(), _events.end(), Later);
+        Event event = std::move(_events.back());
+        _events.pop_back();
+        event.callback(event.cycle);
+    }
+    Update();
+}
+
+auto InterruptController::Update() -> void
+{
+    if (_nmi || (_irq != 0 && !_masked))
+    {
+        _deadline = 0;
+    }
+    else
+    {
+        _deadline = _events.empty() ? Never : _events.front().cycle;
+    }
+}
+
+auto InterruptController::Later(const Event& left, const Event& right) -> bool
+{
+    return left.cycle != right.cycle ? left.cycle > right.cycle : left.id > right.id;
+}
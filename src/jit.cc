@@ -0,0 +1,423 @@
+#include <jit.hh>
+#include <cstddef>
+#include <cstring>
+
+#if defined(CPU6502_JIT) && defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CPU6502_JIT_SUPPORTED 1
+#else
+#define CPU6502_JIT_SUPPORTED 0
+#endif
+
+Jit::Jit() : _buffer(nullptr), _used(0), _full(false)
+{
+#if CPU6502_JIT_SUPPORTED
+    void* buffer = mmap(nullptr, BufferSize, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer != MAP_FAILED)
+    {
+        _buffer = static_cast<u8*>(buffer);
+    }
+#endif
+}
+
+Jit::~Jit()
+{
+#if CPU6502_JIT_SUPPORTED
+    if (_buffer != nullptr)
+    {
+        munmap(_buffer, BufferSize);
+    }
+#endif
+}
+
+auto Jit::IsSupported() -> bool
+{
+    return CPU6502_JIT_SUPPORTED;
+}
+
+auto Jit::Compile(u16 address, std::span<const BlockCache::Record> records, const Instruction* instructions) -> BlockCache::NativeCode
+{
+    if (_buffer == nullptr || records.empty())
+    {
+        return nullptr;
+    }
+
+    std::vector<u8> code;
+    Emit(code, { 0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56 });
+    Emit(code, { 0x48, 0x83, 0xEC, 0x08 });
+    Emit(code, { 0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4, 0x49, 0x89, 0xD5, 0x45, 0x8B, 0x75, 0x00 });
+
+    // Fields are addressed as [rbx + disp8], which only reaches the first 128 bytes of CPU.
+    static_assert(offsetof(CPU, PC) < 0x80);
+    static_assert(offsetof(CPU, SP) < 0x80);
+    static_assert(offsetof(CPU, PS) < 0x80);
+    static_assert(offsetof(CPU, A) < 0x80);
+    static_assert(offsetof(CPU, X) < 0x80);
+    static_assert(offsetof(CPU, Y) < 0x80);
+    static_assert(offsetof(CPU, _carry) < 0x80);
+    static_assert(offsetof(CPU, _overflow) < 0x80);
+    static_assert(offsetof(CPU, _zero) < 0x80);
+    static_assert(offsetof(CPU, _negative) < 0x80);
+    static_assert(offsetof(CPU, _cycles) < 0x80);
+    static_assert(offsetof(CPU, _deadline) < 0x80);
+
+    constexpr u8 Cycles = offsetof(CPU, _cycles);
+    constexpr u8 Deadline = offsetof(CPU, _deadline);
+
+    std::vector<u64> exits;
+    u16 pc = address;
+    u64 cycles = 0;
+    bool native = false;
+    for (u64 index = 0; index < records.size(); index++)
+    {
+        const BlockCache::Record& record = records[index];
+        pc += record.length;
+
+        native = Translate(code, record, instructions[record.opcode], pc);
+        if (native)
+        {
+            cycles += record.cycles;
+            continue;
+        }
+
+        AddCycles(code, cycles);
+        cycles = 0;
+        StorePC(code, pc);
+        Call(code, record);
+
+        if (record.accesses && index + 1 < records.size())
+        {
+            if (record.writes)
+            {
+                Emit(code, { 0x45, 0x39, 0x75, 0x00, 0x75, 0x0D });
+            }
+            Emit(code, { 0x48, 0x8B, 0x43, Deadline, 0x48, 0x8B, 0x00, 0x48, 0x39, 0x43, Cycles, 0x72, 0x0A, 0xB8 });
+            Emit32(code, index + 1);
+            Emit(code, { 0xE9 });
+            exits.push_back(code.size());
+            Emit32(code, 0);
+        }
+    }
+
+    AddCycles(code, cycles);
+    if (native && !Jumps(instructions[records.back().opcode].operation))
+    {
+        StorePC(code, pc);
+    }
+    Emit(code, { 0xB8 });
+    Emit32(code, records.size());
+
+    for (u64 exit : exits)
+    {
+        Patch32(code, exit, code.size() - (exit + 4));
+    }
+    Emit(code, { 0x48, 0x83, 0xC4, 0x08, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3 });
+
+    if (_used + code.size() > BufferSize)
+    {
+        _full = true;
+        return nullptr;
+    }
+
+#if CPU6502_JIT_SUPPORTED
+    static const u64 PageSize = sysconf(_SC_PAGESIZE);
+    u64 first = _used & ~(PageSize - 1);
+    u64 last = (_used + code.size() + PageSize - 1) & ~(PageSize - 1);
+    if (mprotect(_buffer + first, last - first, PROT_READ | PROT_WRITE) != 0)
+    {
+        return nullptr;
+    }
+    std::memcpy(_buffer + _used, code.data(), code.size());
+    if (mprotect(_buffer + first, last - first, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(_buffer, BufferSize);
+        _buffer = nullptr;
+        return nullptr;
+    }
+#endif
+
+    auto compiled = reinterpret_cast<BlockCache::NativeCode>(_buffer + _used);
+    _used += (code.size() + 15) & ~u64(15);
+    return compiled;
+}
+
+auto Jit::Reset() -> void
+{
+    _used = 0;
+    _full = false;
+}
+
+auto Jit::GetUsedBytes() const -> u64
+{
+    return _used;
+}
+
+auto Jit::IsAvailable() const -> bool
+{
+    return _buffer != nullptr;
+}
+
+auto Jit::IsFull() const -> bool
+{
+    return _full;
+}
+
+auto Jit::Translate(std::vector<u8>& code, const BlockCache::Record& record, const Instruction& instruction, u16 pc) -> bool
+{
+    constexpr u8 PC = offsetof(CPU, PC);
+    constexpr u8 SP = offsetof(CPU, SP);
+    constexpr u8 PS = offsetof(CPU, PS);
+    constexpr u8 A = offsetof(CPU, A);
+    constexpr u8 X = offsetof(CPU, X);
+    constexpr u8 Y = offsetof(CPU, Y);
+    constexpr u8 Carry = offsetof(CPU, _carry);
+    constexpr u8 Overflow = offsetof(CPU, _overflow);
+    constexpr u8 Zero = offsetof(CPU, _zero);
+    constexpr u8 Negative = offsetof(CPU, _negative);
+    constexpr u8 Cycles = offsetof(CPU, _cycles);
+
+    u8 operand = record.operand;
+    bool immediate = instruction.addressingMode == AddressingMode::Immediate;
+
+    switch (instruction.operation)
+    {
+        case Operation::LDA:
+        case Operation::LDX:
+        case Operation::LDY:
+        {
+            if (!immediate)
+            {
+                return false;
+            }
+            u8 target = instruction.operation == Operation::LDA ? A : instruction.operation == Operation::LDX ? X : Y;
+            Emit(code, { 0xC6, 0x43, target, operand, 0xC6, 0x43, Zero, operand, 0xC6, 0x43, Negative, operand });
+            return true;
+        }
+        case Operation::TAX:
+        case Operation::TAY:
+        case Operation::TSX:
+        case Operation::TXA:
+        case Operation::TXS:
+        case Operation::TYA:
+        {
+            u8 source = instruction.operation == Operation::TAX || instruction.operation == Operation::TAY ? A : instruction.operation == Operation::TSX ? SP : instruction.operation == Operation::TYA ? Y : X;
+            u8 target = instruction.operation == Operation::TAX || instruction.operation == Operation::TSX ? X : instruction.operation == Operation::TAY ? Y : instruction.operation == Operation::TXS ? SP : A;
+            Emit(code, { 0x8A, 0x43, source, 0x88, 0x43, target });
+            if (instruction.operation != Operation::TXS)
+            {
+                SetResult(code);
+            }
+            return true;
+        }
+        case Operation::INX:
+        case Operation::INY:
+        case Operation::DEX:
+        case Operation::DEY:
+        {
+            u8 target = instruction.operation == Operation::INX || instruction.operation == Operation::DEX ? X : Y;
+            u8 modrm = instruction.operation == Operation::INX || instruction.operation == Operation::INY ? 0xC0 : 0xC8;
+            Emit(code, { 0x8A, 0x43, target, 0xFE, modrm, 0x88, 0x43, target });
+            SetResult(code);
+            return true;
+        }
+        case Operation::AND:
+        case Operation::EOR:
+        case Operation::ORA:
+        {
+            if (!immediate)
+            {
+                return false;
+            }
+            u8 opcode = instruction.operation == Operation::AND ? 0x24 : instruction.operation == Operation::EOR ? 0x34 : 0x0C;
+            Emit(code, { 0x8A, 0x43, A, opcode, operand, 0x88, 0x43, A });
+            SetResult(code);
+            return true;
+        }
+        case Operation::CMP:
+        case Operation::CPX:
+        case Operation::CPY:
+        {
+            if (!immediate)
+            {
+                return false;
+            }
+            u8 source = instruction.operation == Operation::CMP ? A : instruction.operation == Operation::CPX ? X : Y;
+            Emit(code, { 0x8A, 0x43, source, 0x2C, operand, 0x0F, 0x93, 0x43, Carry });
+            SetResult(code);
+            return true;
+        }
+        case Operation::ADC:
+        case Operation::SBC:
+        {
+            if (!immediate)
+            {
+                return false;
+            }
+            bool adc = instruction.operation == Operation::ADC;
+            Emit(code, { 0xF6, 0x43, PS, 0x08, 0x74, 0x00 });
+            u64 binary = code.size();
+            Call(code, record);
+            Emit(code, { 0x48, 0x81, 0x6B, Cycles });
+            Emit32(code, record.cycles);
+            Emit(code, { 0xEB, 0x00 });
+            u64 done = code.size();
+            code[binary - 1] = done - binary;
+
+            Emit(code, { 0x0F, 0xB6, 0x4B, Carry, 0xD1, 0xE9 });
+            if (!adc)
+            {
+                Emit(code, { 0xF5 });
+            }
+            Emit(code, { 0x8A, 0x43, A, static_cast<u8>(adc ? 0x14 : 0x1C), operand, 0x88, 0x43, A });
+            Emit(code, { 0x0F, static_cast<u8>(adc ? 0x92 : 0x93), 0x43, Carry, 0x0F, 0x90, 0x43, Overflow });
+            SetResult(code);
+            code[done - 1] = code.size() - done;
+            return true;
+        }
+        case Operation::CLC:
+            Emit(code, { 0xC6, 0x43, Carry, 0x00 });
+            return true;
+        case Operation::SEC:
+            Emit(code, { 0xC6, 0x43, Carry, 0x01 });
+            return true;
+        case Operation::SEI:
+            SetFlags(code, 0x04, 0x04);
+            return true;
+        case Operation::CLD:
+            SetFlags(code, 0x08, 0x00);
+            return true;
+        case Operation::SED:
+            SetFlags(code, 0x08, 0x08);
+            return true;
+        case Operation::CLV:
+            Emit(code, { 0xC6, 0x43, Overflow, 0x00 });
+            return true;
+        case Operation::NOP:
+            return instruction.addressingMode == AddressingMode::Implicit || immediate;
+        case Operation::JMP:
+        {
+            if (instruction.addressingMode != AddressingMode::Absolute)
+            {
+                return false;
+            }
+            StorePC(code, record.operand);
+            return true;
+        }
+        case Operation::BCC:
+        case Operation::BCS:
+        case Operation::BEQ:
+        case Operation::BMI:
+        case Operation::BNE:
+        case Operation::BPL:
+        case Operation::BVC:
+        case Operation::BVS:
+        {
+            Operation operation = instruction.operation;
+            u8 flag = operation == Operation::BCC || operation == Operation::BCS ? Carry : operation == Operation::BEQ || operation == Operation::BNE ? Zero : operation == Operation::BVC || operation == Operation::BVS ? Overflow : Negative;
+            u8 mask = flag == Negative ? 0x80 : 0xFF;
+            bool nonzero = operation == Operation::BCS || operation == Operation::BNE || operation == Operation::BMI || operation == Operation::BVS;
+            u16 target = pc + static_cast<signed char>(operand);
+            u32 penalty = 1 + CPU::PageCrossed(pc, target);
+
+            Emit(code, { 0xF6, 0x43, flag, mask, static_cast<u8>(nonzero ? 0x74 : 0x75), 0x10 });
+            Emit(code, { 0x66, 0xC7, 0x43, PC });
+            Emit16(code, target);
+            Emit(code, { 0x48, 0x81, 0x43, Cycles });
+            Emit32(code, penalty);
+            Emit(code, { 0xEB, 0x06 });
+            StorePC(code, pc);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+auto Jit::Jumps(Operation operation) -> bool
+{
+    switch (operation)
+    {
+        case Operation::BCC:
+        case Operation::BCS:
+        case Operation::BEQ:
+        case Operation::BMI:
+        case Operation::BNE:
+        case Operation::BPL:
+        case Operation::BVC:
+        case Operation::BVS:
+        case Operation::JMP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+auto Jit::Call(std::vector<u8>& code, const BlockCache::Record& record) -> void
+{
+    Emit(code, { 0x48, 0x89, 0xDF, 0x4C, 0x89, 0xE6, 0xBA });
+    Emit32(code, record.operand);
+    Emit(code, { 0x48, 0xB8 });
+    Emit64(code, reinterpret_cast<u64>(record.handler));
+    Emit(code, { 0xFF, 0xD0 });
+}
+
+auto Jit::SetResult(std::vector<u8>& code) -> void
+{
+    Emit(code, { 0x88, 0x43, static_cast<u8>(offsetof(CPU, _zero)), 0x88, 0x43, static_cast<u8>(offsetof(CPU, _negative)) });
+}
+
+auto Jit::SetFlags(std::vector<u8>& code, u8 mask, u8 flags) -> void
+{
+    constexpr u8 PS = offsetof(CPU, PS);
+    Emit(code, { 0x80, 0x63, PS, static_cast<u8>(~mask) });
+    if (flags != 0)
+    {
+        Emit(code, { 0x80, 0x4B, PS, flags });
+    }
+}
+
+auto Jit::StorePC(std::vector<u8>& code, u16 pc) -> void
+{
+    Emit(code, { 0x66, 0xC7, 0x43, static_cast<u8>(offsetof(CPU, PC)) });
+    Emit16(code, pc);
+}
+
+auto Jit::AddCycles(std::vector<u8>& code, u64 cycles) -> void
+{
+    if (cycles != 0)
+    {
+        Emit(code, { 0x48, 0x81, 0x43, static_cast<u8>(offsetof(CPU, _cycles)) });
+        Emit32(code, cycles);
+    }
+}
+
+auto Jit::Emit(std::vector<u8>& code, std::initializer_list<u8> bytes) -> void
+{
+    code.insert(code.end(), bytes);
+}
+
+auto Jit::Emit16(std::vector<u8>& code, u16 value) -> void
+{
+    Emit(code, { static_cast<u8>(value), static_cast<u8>(value >> 8) });
+}
+
+auto Jit::Emit32(std::vector<u8>& code, u32 value) -> void
+{
+    Emit16(code, value);
+    Emit16(code, value >> 16);
+}
+
+auto Jit::Emit64(std::vector<u8>& code, u64 value) -> void
+{
+    Emit32(code, value);
+    Emit32(code, value >> 32);
+}
+
+auto Jit::Patch32(std::vector<u8>& code, u64 position, u32 value) -> void
+{
+    for (u32 index = 0; index < 4; index++)
+    {
+        code[position + index] = value >> (index * 8);
+    }
+}
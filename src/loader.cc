@@ -0,0 +1,279 @@
+#include <loader.hh>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CPU6502_MMAP 1
+#else
+#define CPU6502_MMAP 0
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path) : _data(nullptr), _size(0)
+{
+#if CPU6502_MMAP
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        throw std::runtime_error("cannot open " + path.string());
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0)
+    {
+        close(descriptor);
+        throw std::runtime_error("cannot stat " + path.string());
+    }
+
+    _size = status.st_size;
+    if (_size != 0)
+    {
+        void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            close(descriptor);
+            throw std::runtime_error("cannot map " + path.string());
+        }
+        _data = static_cast<const u8*>(data);
+    }
+    close(descriptor);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("cannot open " + path.string());
+    }
+    _buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    _data = _buffer.data();
+    _size = _buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if CPU6502_MMAP
+    if (_data != nullptr)
+    {
+        munmap(const_cast<u8*>(_data), _size);
+    }
+#endif
+}
+
+auto MappedFile::GetData() const -> std::span<const u8>
+{
+    return { _data, _size };
+}
+
+auto Loader::Detect(const std::filesystem::path& path) -> ImageFormat
+{
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return std::tolower(c); });
+    if (extension == ".nes")
+    {
+        return ImageFormat::INes;
+    }
+    if (extension == ".hex" || extension == ".ihx" || extension == ".ihex")
+    {
+        return ImageFormat::IntelHex;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    char magic[4] = {};
+    file.read(magic, sizeof(magic));
+    if (file.gcount() == 4 && std::equal(magic, magic + 4, "NES\x1A"))
+    {
+        return ImageFormat::INes;
+    }
+    return ImageFormat::Binary;
+}
+
+auto Loader::Load(Image& image, const std::filesystem::path& path, u16 address) -> std::optional<u16>
+{
+    return Load(image, path, Detect(path), address);
+}
+
+auto Loader::Load(Image& image, const std::filesystem::path& path, ImageFormat format, u16 address) -> std::optional<u16>
+{
+    auto file = std::make_shared<const MappedFile>(path);
+    switch (format)
+    {
+        case ImageFormat::Binary:
+            LoadBinary(image, file, 0, file->GetData().size(), address);
+            return address;
+        case ImageFormat::IntelHex:
+            return LoadIntelHex(image, *file);
+        case ImageFormat::INes:
+            LoadINes(image, file);
+            return 0x8000;
+    }
+    return std::nullopt;
+}
+
+auto Loader::LoadBinary(Image& image, const std::shared_ptr<const MappedFile>& file, u64 offset, u64 size, u16 address) -> void
+{
+    if (address + size > 0x10000)
+    {
+        throw std::runtime_error("image does not fit in the address space");
+    }
+
+    std::span<const u8> data = file->GetData().subspan(offset, size);
+    u32 end = address + size;
+    for (u32 start = address; start < end;)
+    {
+        u32 next = std::min<u32>((start & ~0xFF) + Memory::PageSize, end);
+        std::span<const u8> chunk = data.subspan(start - address, next - start);
+        if (chunk.size() == Memory::PageSize)
+        {
+            image.SetPage(start >> 8, std::shared_ptr<const Memory::Page>(file, reinterpret_cast<const Memory::Page*>(chunk.data())));
+        }
+        else
+        {
+            image.Write(start, chunk);
+        }
+        start = next;
+    }
+}
+
+auto Loader::LoadIntelHex(Image& image, const MappedFile& file) -> std::optional<u16>
+{
+    std::span<const u8> text = file.GetData();
+    std::optional<u16> start;
+    u32 base = 0;
+    while (!text.empty())
+    {
+        u64 length = std::find(text.begin(), text.end(), '\n') - text.begin();
+        std::span<const u8> line = text.first(length);
+        text = text.subspan(std::min<u64>(length + 1, text.size()));
+
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+        {
+            line = line.first(line.size() - 1);
+        }
+        if (line.empty())
+        {
+            continue;
+        }
+        if (line[0] != ':' || line.size() < 11 || line.size() % 2 == 0)
+        {
+            throw std::runtime_error("invalid Intel HEX record");
+        }
+
+        std::vector<u8> record;
+        for (u64 index = 1; index < line.size(); index += 2)
+        {
+            record.push_back(ParseHex(line.subspan(index, 2)));
+        }
+
+        u8 count = record[0];
+        if (record.size() != count + 5u)
+        {
+            throw std::runtime_error("invalid Intel HEX record length");
+        }
+        u8 checksum = 0;
+        for (u8 value : record)
+        {
+            checksum += value;
+        }
+        if (checksum != 0)
+        {
+            throw std::runtime_error("invalid Intel HEX checksum");
+        }
+
+        u16 offset = record[1] << 8 | record[2];
+        std::span<const u8> data = std::span<const u8>(record).subspan(4, count);
+        switch (record[3])
+        {
+            case 0x00:
+                if (base + offset + count > 0x10000)
+                {
+                    throw std::runtime_error("Intel HEX record does not fit in the address space");
+                }
+                image.Write(base + offset, data);
+                if (count != 0 && !start.has_value())
+                {
+                    start = base + offset;
+                }
+                break;
+            case 0x01:
+                return start;
+            case 0x02:
+                if (count != 2)
+                {
+                    throw std::runtime_error("invalid Intel HEX segment record");
+                }
+                base = (data[0] << 8 | data[1]) << 4;
+                break;
+            case 0x04:
+                if (count != 2)
+                {
+                    throw std::runtime_error("invalid Intel HEX linear address record");
+                }
+                base = (data[0] << 8 | data[1]) << 16;
+                break;
+            case 0x03:
+            case 0x05:
+                break;
+            default:
+                throw std::runtime_error("unsupported Intel HEX record type");
+        }
+    }
+    return start;
+}
+
+auto Loader::LoadINes(Image& image, const std::shared_ptr<const MappedFile>& file) -> void
+{
+    std::span<const u8> data = file->GetData();
+    if (data.size() < INesHeaderSize || !std::equal(data.begin(), data.begin() + 4, "NES\x1A"))
+    {
+        throw std::runtime_error("invalid iNES header");
+    }
+
+    u8 mapper = (data[6] >> 4) | (data[7] & 0xF0);
+    if (mapper != 0)
+    {
+        throw std::runtime_error("unsupported iNES mapper " + std::to_string(mapper) + ", only mapper 0 (NROM) can be loaded");
+    }
+
+    u64 offset = INesHeaderSize + (data[6] & 0x04 ? INesTrainerSize : 0);
+    u64 size = data[4] * INesBankSize;
+    if (size == 0 || offset + size > data.size())
+    {
+        throw std::runtime_error("invalid iNES program size");
+    }
+
+    LoadBinary(image, file, offset, INesBankSize, 0x8000);
+    LoadBinary(image, file, offset + size - INesBankSize, INesBankSize, 0xC000);
+}
+
+auto Loader::ParseHex(std::span<const u8> text) -> u8
+{
+    u8 value = 0;
+    for (u8 digit : text)
+    {
+        value <<= 4;
+        if (digit >= '0' && digit <= '9')
+        {
+            value |= digit - '0';
+        }
+        else if (digit >= 'A' && digit <= 'F')
+        {
+            value |= digit - 'A' + 10;
+        }
+        else if (digit >= 'a' && digit <= 'f')
+        {
+            value |= digit - 'a' + 10;
+        }
+        else
+        {
+            throw std::runtime_error("invalid Intel HEX digit");
+        }
+    }
+    return value;
+}
@@ -0,0 +1,73 @@
+#include <lockstep.hh>
+#include <algorithm>
+
+Lockstep::Lockstep(Engine reference, Engine candidate, u64 stride)
+    : _reference(std::move(reference)), _candidate(std::move(candidate)), _stride(std::max<u64>(stride, 1))
+{
+}
+
+auto Lockstep::Run(const Image& image, u16 entry, u64 instructions) -> std::optional<Divergence>
+{
+    CPU expectedCPU;
+    CPU actualCPU;
+    Memory expectedMemory;
+    Memory actualMemory;
+    expectedMemory.Map(image);
+    actualMemory.Map(image);
+
+    Registers registers = expectedCPU.GetRegisters();
+    registers.PC = entry;
+    expectedCPU.SetRegisters(registers);
+    actualCPU.SetRegisters(registers);
+
+    u64 executed = 0;
+    while (executed < instructions)
+    {
+        u64 count = std::min(_stride, instructions - executed);
+        RunResult expected = _reference(expectedCPU, expectedMemory, count);
+        RunResult actual = _candidate(actualCPU, actualMemory, count);
+        executed += expected.instructions;
+
+        Registers expectedRegisters = expectedCPU.GetRegisters();
+        Registers actualRegisters = actualCPU.GetRegisters();
+        bool same = expected.reason == actual.reason && expected.instructions == actual.instructions;
+        same = same && expectedRegisters.PC == actualRegisters.PC && expectedRegisters.SP == actualRegisters.SP;
+        same = same && expectedRegisters.A == actualRegisters.A && expectedRegisters.X == actualRegisters.X;
+        same = same && expectedRegisters.Y == actualRegisters.Y && expectedRegisters.PS == actualRegisters.PS;
+        same = same && expectedCPU.GetCycles() == actualCPU.GetCycles();
+
+        std::optional<u16> address = Compare(expectedMemory, actualMemory);
+        if (!same || address.has_value())
+        {
+            return Divergence{ executed, expectedRegisters, actualRegisters, expectedCPU.GetCycles(), actualCPU.GetCycles(), address };
+        }
+
+        if (expected.reason == StopReason::Break || expected.reason == StopReason::IllegalOpcode)
+        {
+            break;
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto Lockstep::Compare(const Memory& expected, const Memory& actual) -> std::optional<u16>
+{
+    for (u32 page = 0; page < Memory::PageCount; page++)
+    {
+        const u8* left = expected.GetPage(page);
+        const u8* right = actual.GetPage(page);
+        if (left == right)
+        {
+            continue;
+        }
+
+        auto [first, second] = std::mismatch(left, left + Memory::PageSize, right);
+        if (first != left + Memory::PageSize)
+        {
+            return static_cast<u16>(page << 8 | (first - left));
+        }
+    }
+
+    return std::nullopt;
+}
@@ -1,21 +1,173 @@
-#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <cpu.hh>
+#include <gdbserver.hh>
+#include <loader.hh>
 #include <memory.hh>
+#include <profiler.hh>
+#include <trace.hh>
+
+static constexpr u8 Program[] = {
+    0xA9, 0x31, // 0600: LDA #$31
+    0x0A,       // 0602: ASL A
+    0x00,       // 0603: BRK
+};
+
+static auto ParseAddress(const std::string& text) -> u16
+{
+    u64 value = std::stoul(text, nullptr, 0);
+    if (value > 0xFFFF)
+    {
+        throw std::out_of_range("address out of range: " + text);
+    }
+    return value;
+}
 
 auto main(int argc, char** argv) -> int
 {
-    (void)argc;
-    (void)argv;
+    Image image;
+    std::optional<u16> entry;
+    std::optional<u16> start;
+    std::optional<std::string> profile;
+    std::optional<std::string> stacks;
+    std::optional<std::string> trace;
+    std::optional<std::string> gdb;
+    bool loaded = false;
+
+    try
+    {
+        for (int index = 1; index < argc; index++)
+        {
+            std::string argument = argv[index];
+            if (argument == "--entry" && index + 1 < argc)
+            {
+                entry = ParseAddress(argv[++index]);
+                continue;
+            }
+            if (argument == "--profile" && index + 1 < argc)
+            {
+                profile = argv[++index];
+                continue;
+            }
+            if (argument == "--stacks" && index + 1 < argc)
+            {
+                stacks = argv[++index];
+                continue;
+            }
+            if (argument == "--trace" && index + 1 < argc)
+            {
+                trace = argv[++index];
+                continue;
+            }
+            if (argument == "--gdb" && index + 1 < argc)
+            {
+                gdb = argv[++index];
+                continue;
+            }
+            if (argument.starts_with("-"))
+            {
+                std::fprintf(stderr, "usage: %s [--entry ADDRESS] [--profile FILE] [--stacks FILE] [--trace FILE] [--gdb [HOST]:PORT|PATH] [IMAGE[@ADDRESS]]...\n", argv[0]);
+                return 1;
+            }
+
+            u16 address = 0x0000;
+            u64 separator = argument.rfind('@');
+            if (separator != std::string::npos)
+            {
+                address = ParseAddress(argument.substr(separator + 1));
+                argument.resize(separator);
+            }
+
+            ImageFormat format = Loader::Detect(argument);
+            std::optional<u16> origin = Loader::Load(image, argument, format, address);
+            loaded = true;
+            if (!start.has_value())
+            {
+                start = origin;
+            }
+        }
+    }
+    catch (const std::exception& exception)
+    {
+        std::fprintf(stderr, "%s\n", exception.what());
+        return 1;
+    }
+
+    if (!loaded)
+    {
+        image.Write(0x0600, Program);
+        start = 0x0600;
+    }
+
+    bool vector = image.GetPage(CPU::ResetVector >> 8) != nullptr;
+    if (!entry.has_value() && !vector && !start.has_value())
+    {
+        std::fprintf(stderr, "the images have no reset vector and no data to start at, pass --entry\n");
+        return 1;
+    }
 
     CPU cpu;
     Memory memory;
+    memory.Map(image);
+
+    if (vector)
+    {
+        cpu.Reset(memory);
+    }
+
+    Registers registers = cpu.GetRegisters();
+    if (entry.has_value() || !vector)
+    {
+        registers.PC = entry.value_or(*start);
+        cpu.SetRegisters(registers);
+    }
+
+    if (gdb.has_value())
+    {
+        try
+        {
+            GdbServer server(cpu, memory);
+            server.Listen(*gdb);
+            std::fprintf(stderr, "waiting for a debugger on %s\n", gdb->c_str());
+            server.Serve();
+        }
+        catch (const std::exception& exception)
+        {
+            std::fprintf(stderr, "%s\n", exception.what());
+            return 1;
+        }
+    }
+    else if (profile.has_value() || stacks.has_value())
+    {
+        Profiler profiler;
+        cpu.Run(memory, profiler);
 
-    u16 address = 0x0600;
-    memory.Write(address++, static_cast<u8>(OperationCode::LDA_Immediate));
-    memory.Write(address++, 0x31);
-    memory.Write(address++, static_cast<u8>(OperationCode::ASL_Accumulator));
-    memory.Write(address++, static_cast<u8>(OperationCode::BRK_Implied));
+        if (profile.has_value())
+        {
+            std::ofstream stream(*profile);
+            profiler.WriteFlatProfile(stream);
+        }
+        if (stacks.has_value())
+        {
+            std::ofstream stream(*stacks);
+            profiler.WriteCollapsedStacks(stream);
+        }
+    }
+    else if (trace.has_value())
+    {
+        Trace recorder;
+        recorder.Open(*trace);
+        cpu.Run(memory, recorder);
+    }
+    else
+    {
+        cpu.Run(memory);
+    }
 
-    cpu.Run(memory);
+    registers = cpu.GetRegisters();
+    std::printf("PC=$%04X A=$%02X X=$%02X Y=$%02X SP=$%02X PS=$%02X cycles=%llu\n", registers.PC, registers.A, registers.X, registers.Y, registers.SP, registers.PS, cpu.GetCycles());
     return 0;
 }
@@ -1,22 +1,379 @@
 #include <memory.hh>
-#include <cstring>
+#include <algorithm>
+#include <atomic>
+
+const Memory::Page Memory::Zero = {};
+
+static std::atomic<u64> Next = 1;
 
 Memory::Memory()
 {
+    _id = Next++;
+    for (u32 page = 0; page < DirectPageCount; page++)
+    {
+        _owned[page] = std::make_unique<Page>();
+    }
     Reset();
 }
 
 auto Memory::Reset() -> void
 {
-    std::memset(_data, 0, sizeof(_data));
+    _read.fill(Zero.data());
+    _write.fill(nullptr);
+    for (u32 page = 0; page < PageCount; page++)
+    {
+        if (page < DirectPageCount)
+        {
+            _owned[page]->fill(0);
+        }
+        else
+        {
+            _owned[page].reset();
+        }
+        Invalidate(page);
+    }
+    _shared.reset();
+    _base.reset();
+
+    for (u32 page = 0; page < DirectPageCount; page++)
+    {
+        Remap(page);
+    }
+
+    for (u32 page = DirectPageCount; _devices.any() && page < PageCount; page++)
+    {
+        if (_devices[page])
+        {
+            Remap(page);
+        }
+    }
+}
+
+auto Memory::Map(const Image& image) -> void
+{
+    for (u32 page = 0; page < PageCount; page++)
+    {
+        std::shared_ptr<const Page> data = image.GetPage(page);
+        if (data != nullptr)
+        {
+            Replace(page, std::move(data));
+        }
+    }
+}
+
+auto Memory::Attach(u16 first, u16 last, Device& device) -> void
+{
+    _mappings.push_back({ first, last, &device });
+    for (u32 page = first >> 8; page <= static_cast<u32>(last >> 8); page++)
+    {
+        _devices.set(page);
+        Invalidate(page);
+        Remap(page);
+    }
+}
+
+auto Memory::Detach(Device& device) -> void
+{
+    std::erase_if(_mappings, [&device](const Mapping& mapping) { return mapping.device == &device; });
+
+    _devices.reset();
+    for (const Mapping& mapping : _mappings)
+    {
+        for (u32 page = mapping.first >> 8; page <= static_cast<u32>(mapping.last >> 8); page++)
+        {
+            _devices.set(page);
+        }
+    }
+
+    for (u32 page = 0; page < PageCount; page++)
+    {
+        Invalidate(page);
+        Remap(page);
+    }
+}
+
+auto Memory::GetOwnedPageCount() const -> u32
+{
+    return GetDirtyPages().count();
+}
+
+auto Memory::GetDirtyPages() const -> std::bitset<PageCount>
+{
+    std::bitset<PageCount> dirty;
+    for (u32 page = 0; page < PageCount; page++)
+    {
+        dirty[page] = _owned[page] != nullptr;
+    }
+    return dirty;
+}
+
+auto Memory::GetPage(u8 page) const -> const u8*
+{
+    return Backing(page);
+}
+
+auto Memory::Capture() -> Pages
+{
+    if (_shared == nullptr)
+    {
+        _shared = std::make_unique<Pages>();
+    }
+
+    Pages& shared = *_shared;
+    for (u32 page = 0; page < PageCount; page++)
+    {
+        if (page < DirectPageCount)
+        {
+            shared[page] = std::make_shared<const Page>(*_owned[page]);
+        }
+        else if (_owned[page] != nullptr)
+        {
+            shared[page] = std::shared_ptr<const Page>(std::move(_owned[page]));
+            Remap(page);
+        }
+        else if (shared[page] == nullptr && _base != nullptr)
+        {
+            shared[page] = (*_base)[page];
+        }
+    }
+    _base.reset();
+    return shared;
+}
+
+auto Memory::Restore(const Pages& pages) -> void
+{
+    std::shared_ptr<const Pages> base = std::move(_base);
+    for (u32 page = 0; page < PageCount; page++)
+    {
+        Replace(page, pages[page]);
+    }
+}
+
+auto Memory::Inherit(std::shared_ptr<const Pages> pages) -> void
+{
+    std::shared_ptr<const Pages> base = std::move(_base);
+    _base = std::move(pages);
+    _shared.reset();
+    for (u32 page = 0; page < PageCount; page++)
+    {
+        const std::shared_ptr<const Page>& data = (*_base)[page];
+        if (page < DirectPageCount)
+        {
+            std::copy_n(data != nullptr ? data->data() : Zero.data(), PageSize, _owned[page]->data());
+        }
+        else if (_owned[page] != nullptr)
+        {
+            _owned[page].reset();
+        }
+
+        Invalidate(page);
+
+        if (page < DirectPageCount || _devices[page]) [[unlikely]]
+        {
+            Remap(page);
+            continue;
+        }
+
+        _read[page] = data != nullptr ? data->data() : Zero.data();
+        _write[page] = nullptr;
+    }
+}
+
+auto Memory::MarkCode(u16 first, u16 last) -> void
+{
+    for (u32 address = first; address <= last; address++)
+    {
+        if (_code == nullptr) [[unlikely]]
+        {
+            _code = std::make_unique<Code>();
+        }
+
+        std::unique_ptr<std::bitset<PageSize>>& code = _code->pages[address >> 8];
+        if (code == nullptr)
+        {
+            code = std::make_unique<std::bitset<PageSize>>();
+            _write[address >> 8] = nullptr;
+        }
+        code->set(address & 0xFF);
+    }
+}
+
+auto Memory::IsDevice(u8 page) const -> bool
+{
+    return _devices[page];
+}
+
+auto Memory::Backing(u8 page) const -> const u8*
+{
+    if (_owned[page] != nullptr)
+    {
+        return _owned[page]->data();
+    }
+
+    if (_shared != nullptr && (*_shared)[page] != nullptr)
+    {
+        return (*_shared)[page]->data();
+    }
+
+    if (_base != nullptr && (*_base)[page] != nullptr)
+    {
+        return (*_base)[page]->data();
+    }
+
+    return Zero.data();
+}
+
+auto Memory::Remap(u8 page) -> void
+{
+    if (page < DirectPageCount)
+    {
+        u8* direct = _devices[page] ? nullptr : _owned[page]->data();
+        if (_direct[page] != direct)
+        {
+            _direct[page] = direct;
+            _layout = Next++;
+        }
+    }
+
+    if (_devices[page])
+    {
+        _read[page] = nullptr;
+        _write[page] = nullptr;
+        return;
+    }
+
+    _read[page] = Backing(page);
+    _write[page] = _owned[page] != nullptr && !IsCode(page) ? _owned[page]->data() : nullptr;
+}
+
+auto Memory::Replace(u8 page, std::shared_ptr<const Page> data) -> void
+{
+    if (page < DirectPageCount)
+    {
+        const u8* source = data != nullptr ? data->data() : Zero.data();
+        std::copy_n(source, PageSize, _owned[page]->data());
+    }
+    else
+    {
+        _owned[page].reset();
+    }
+    Share(page, std::move(data));
+    Invalidate(page);
+    Remap(page);
+}
+
+auto Memory::Invalidate(u8 page) -> void
+{
+    if (IsCode(page))
+    {
+        _code->pages[page].reset();
+        _code->versions[page]++;
+        _generation++;
+    }
+}
+
+auto Memory::IsCode(u8 page) const -> bool
+{
+    return _code != nullptr && _code->pages[page] != nullptr;
+}
+
+auto Memory::Share(u8 page, std::shared_ptr<const Page> data) -> void
+{
+    if (_shared == nullptr)
+    {
+        if (data == nullptr)
+        {
+            return;
+        }
+        _shared = std::make_unique<Pages>();
+    }
+    (*_shared)[page] = std::move(data);
+}
+
+auto Memory::Own(u8 page) -> u8*
+{
+    if (_owned[page] == nullptr)
+    {
+        auto owned = std::make_unique_for_overwrite<Page>();
+        std::copy_n(Backing(page), PageSize, owned->data());
+        _owned[page] = std::move(owned);
+        Remap(page);
+    }
+    return _owned[page]->data();
+}
+
+auto Memory::ReadDevice(u16 address) const -> u8
+{
+    for (const Mapping& mapping : _mappings)
+    {
+        if (address >= mapping.first && address <= mapping.last)
+        {
+            return mapping.device->Read(address);
+        }
+    }
+    return Backing(address >> 8)[address & 0xFF];
+}
+
+auto Memory::WriteSlow(u16 address, u8 data) -> void
+{
+    if (_devices[address >> 8])
+    {
+        for (const Mapping& mapping : _mappings)
+        {
+            if (address >= mapping.first && address <= mapping.last)
+            {
+                return mapping.device->Write(address, data);
+            }
+        }
+    }
+
+    if (IsCode(address >> 8) && _code->pages[address >> 8]->test(address & 0xFF))
+    {
+        Invalidate(address >> 8);
+        Remap(address >> 8);
+    }
+    Own(address >> 8)[address & 0xFF] = data;
+}
+
+Image::Image(u16 address, std::span<const u8> data)
+{
+    Write(address, data);
+}
+
+auto Image::Write(u16 address, std::span<const u8> data) -> void
+{
+    while (!data.empty())
+    {
+        u8 index = address >> 8;
+        std::shared_ptr<Memory::Page>& page = _pages[index];
+        if (page == nullptr)
+        {
+            page = _mapped[index] != nullptr ? std::make_shared<Memory::Page>(*_mapped[index]) : std::make_shared<Memory::Page>();
+            _mapped[index].reset();
+        }
+        else if (page.use_count() > 1)
+        {
+            page = std::make_shared<Memory::Page>(*page);
+        }
+
+        u64 count = std::min<u64>(data.size(), Memory::PageSize - (address & 0xFF));
+        std::copy_n(data.begin(), count, page->begin() + (address & 0xFF));
+        data = data.subspan(count);
+        address += count;
+    }
 }
 
-auto Memory::Read(u16 address) const -> u8
+auto Image::SetPage(u8 page, std::shared_ptr<const Memory::Page> data) -> void
 {
-    return _data[address];
+    _pages[page].reset();
+    _mapped[page] = std::move(data);
 }
 
-auto Memory::Write(u16 address, u8 data) -> void
+auto Image::GetPage(u8 page) const -> std::shared_ptr<const Memory::Page>
 {
-    _data[address] = data;
+    if (_pages[page] != nullptr)
+    {
+        return _pages[page];
+    }
+    return _mapped[page];
 }
@@ -0,0 +1,173 @@
+#include <profiler.hh>
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <opcodes.hh>
+
+template <typename... Arguments>
+static auto Print(std::ostream& stream, const char* format, Arguments... arguments) -> void
+{
+    char line[128];
+    std::snprintf(line, sizeof(line), format, arguments...);
+    stream << line;
+}
+
+Profiler::Profiler() : _executions(AddressCount), _cycles(AddressCount), _reads(AddressCount), _writes(AddressCount), _calls(AddressCount), _variant(Variant::Nmos)
+{
+    Reset();
+}
+
+auto Profiler::Reset() -> void
+{
+    std::fill(_executions.begin(), _executions.end(), 0);
+    std::fill(_cycles.begin(), _cycles.end(), 0);
+    std::fill(_reads.begin(), _reads.end(), 0);
+    std::fill(_writes.begin(), _writes.end(), 0);
+    std::fill(_calls.begin(), _calls.end(), Calls{ 0, 0, 0 });
+    _opcodes.fill(0);
+    _opcodeCycles.fill(0);
+    _nodes.assign(1, { 0, 0, 0 });
+    _children.clear();
+    _frames.clear();
+    _node = 0;
+}
+
+auto Profiler::GetSubroutines() const -> std::vector<Subroutine>
+{
+    std::vector<Subroutine> subroutines;
+    std::vector<u64> self(AddressCount);
+    for (u32 node = 1; node < _nodes.size(); node++)
+    {
+        self[_nodes[node].address] += _nodes[node].cycles;
+    }
+
+    for (u32 address = 0; address < AddressCount; address++)
+    {
+        if (_calls[address].count != 0)
+        {
+            subroutines.push_back({ static_cast<u16>(address), _calls[address].count, _calls[address].cycles, self[address] });
+        }
+    }
+
+    std::sort(subroutines.begin(), subroutines.end(), [](const Subroutine& left, const Subroutine& right) { return left.inclusiveCycles > right.inclusiveCycles; });
+    return subroutines;
+}
+
+auto Profiler::WriteFlatProfile(std::ostream& stream, u32 limit) const -> void
+{
+    u64 total = std::accumulate(_cycles.begin(), _cycles.end(), u64(0));
+
+    stream << "Subroutines\n";
+    Print(stream, "%12s %14s %14s %7s  %s\n", "calls", "inclusive", "self", "%", "address");
+    std::vector<Subroutine> subroutines = GetSubroutines();
+    for (u64 index = 0; index < std::min<u64>(limit, subroutines.size()); index++)
+    {
+        const Subroutine& subroutine = subroutines[index];
+        Print(stream, "%12llu %14llu %14llu %6.2f%%  $%04X\n", subroutine.calls, subroutine.inclusiveCycles, subroutine.selfCycles, total != 0 ? 100.0 * subroutine.inclusiveCycles / total : 0.0, subroutine.address);
+    }
+
+    stream << "\nHot addresses\n";
+    Print(stream, "%12s %14s %7s  %s\n", "executions", "cycles", "%", "address");
+    std::vector<u16> addresses;
+    for (u32 address = 0; address < AddressCount; address++)
+    {
+        if (_executions[address] != 0)
+        {
+            addresses.push_back(address);
+        }
+    }
+    std::sort(addresses.begin(), addresses.end(), [this](u16 left, u16 right) { return _cycles[left] > _cycles[right]; });
+    for (u64 index = 0; index < std::min<u64>(limit, addresses.size()); index++)
+    {
+        u16 address = addresses[index];
+        Print(stream, "%12llu %14llu %6.2f%%  $%04X\n", _executions[address], _cycles[address], total != 0 ? 100.0 * _cycles[address] / total : 0.0, address);
+    }
+
+    stream << "\nOpcodes\n";
+    Print(stream, "%12s %14s %7s  %s\n", "count", "cycles", "%", "opcode");
+    std::vector<u8> opcodes(0x100);
+    std::iota(opcodes.begin(), opcodes.end(), 0);
+    std::sort(opcodes.begin(), opcodes.end(), [this](u8 left, u8 right) { return _opcodes[left] > _opcodes[right]; });
+    for (u8 opcode : opcodes)
+    {
+        if (_opcodes[opcode] != 0)
+        {
+            Print(stream, "%12llu %14llu %6.2f%%  $%02X %.3s\n", _opcodes[opcode], _opcodeCycles[opcode], total != 0 ? 100.0 * _opcodeCycles[opcode] / total : 0.0, opcode, Mnemonic(GetInstructions(_variant)[opcode].operation).data());
+        }
+    }
+
+    stream << "\nMemory pages\n";
+    Print(stream, "%12s %14s  %s\n", "reads", "writes", "page");
+    for (u32 page = 0; page < AddressCount >> 8; page++)
+    {
+        u64 reads = std::accumulate(_reads.begin() + (page << 8), _reads.begin() + ((page + 1) << 8), u64(0));
+        u64 writes = std::accumulate(_writes.begin() + (page << 8), _writes.begin() + ((page + 1) << 8), u64(0));
+        if (reads != 0 || writes != 0)
+        {
+            Print(stream, "%12llu %14llu  $%02X00\n", reads, writes, page);
+        }
+    }
+}
+
+auto Profiler::WriteCollapsedStacks(std::ostream& stream) const -> void
+{
+    for (u32 node = 0; node < _nodes.size(); node++)
+    {
+        if (_nodes[node].cycles != 0)
+        {
+            stream << Path(node) << ' ' << _nodes[node].cycles << '\n';
+        }
+    }
+}
+
+auto Profiler::Call(u16 address, u8 stack, u64 cycle) -> void
+{
+    _calls[address].count++;
+    if (_frames.size() == MaxDepth)
+    {
+        return;
+    }
+
+    u64 key = static_cast<u64>(_node) << 16 | address;
+    auto [child, inserted] = _children.try_emplace(key, _nodes.size());
+    if (inserted)
+    {
+        _nodes.push_back({ _node, address, 0 });
+    }
+
+    _frames.push_back({ _node, address, stack, cycle });
+    _calls[address].depth++;
+    _node = child->second;
+}
+
+auto Profiler::Return(u8 stack, u64 cycle) -> void
+{
+    while (!_frames.empty() && _frames.back().stack < stack)
+    {
+        Frame frame = _frames.back();
+        _frames.pop_back();
+        if (--_calls[frame.address].depth == 0)
+        {
+            _calls[frame.address].cycles += cycle - frame.start;
+        }
+        _node = frame.node;
+    }
+}
+
+auto Profiler::Path(u32 node) const -> std::string
+{
+    std::vector<u16> addresses;
+    for (; node != 0; node = _nodes[node].parent)
+    {
+        addresses.push_back(_nodes[node].address);
+    }
+
+    std::string path = "root";
+    for (auto address = addresses.rbegin(); address != addresses.rend(); address++)
+    {
+        char frame[8];
+        std::snprintf(frame, sizeof(frame), ";$%04X", *address);
+        path += frame;
+    }
+    return path;
+}
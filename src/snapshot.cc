@@ -0,0 +1,133 @@
+#include <snapshot.hh>
+#include <algorithm>
+#include <stdexcept>
+
+auto Snapshot::Capture(const CPU& cpu, Memory& memory) -> Snapshot
+{
+    Snapshot snapshot;
+    snapshot._registers = cpu.GetRegisters();
+    snapshot._cycles = cpu.GetCycles();
+    snapshot._pages = memory.Capture();
+    return snapshot;
+}
+
+auto Snapshot::Restore(CPU& cpu, Memory& memory) const -> void
+{
+    cpu.SetRegisters(_registers);
+    cpu.SetCycles(_cycles);
+    memory.Restore(_pages);
+}
+
+auto Snapshot::Serialize(const Snapshot* base) const -> std::vector<u8>
+{
+    std::vector<u8> data(std::begin(Magic), std::end(Magic));
+    data.push_back(Version);
+    data.push_back(static_cast<u8>(base != nullptr ? Kind::Incremental : Kind::Full));
+
+    data.push_back(_registers.PC & 0xFF);
+    data.push_back(_registers.PC >> 8);
+    data.push_back(_registers.SP);
+    data.push_back(_registers.A);
+    data.push_back(_registers.X);
+    data.push_back(_registers.Y);
+    data.push_back(_registers.PS);
+    for (u32 shift = 0; shift < 64; shift += 8)
+    {
+        data.push_back(_cycles >> shift);
+    }
+
+    u64 countOffset = data.size();
+    data.push_back(0);
+    data.push_back(0);
+
+    u32 pages = 0;
+    for (u32 page = 0; page < Memory::PageCount; page++)
+    {
+        const Memory::Page* contents = GetPage(page);
+        bool changed;
+        if (base != nullptr)
+        {
+            // Pages captured separately or loaded from a file share no pointers
+            // even when they hold the same bytes, so compare those by contents.
+            changed = _pages[page] != base->_pages[page] && *contents != *base->GetPage(page);
+        }
+        else
+        {
+            changed = _pages[page] != nullptr && std::any_of(contents->begin(), contents->end(), [](u8 value) { return value != 0; });
+        }
+
+        if (changed)
+        {
+            data.push_back(page);
+            data.insert(data.end(), contents->begin(), contents->end());
+            pages++;
+        }
+    }
+
+    data[countOffset] = pages & 0xFF;
+    data[countOffset + 1] = pages >> 8;
+    return data;
+}
+
+auto Snapshot::Deserialize(std::span<const u8> data, const Snapshot* base) -> Snapshot
+{
+    constexpr u64 header = sizeof(Magic) + 2 + 7 + 8 + 2;
+    if (data.size() < header || !std::equal(std::begin(Magic), std::end(Magic), data.begin()) || data[4] != Version || data[5] > static_cast<u8>(Kind::Incremental))
+    {
+        throw std::runtime_error("invalid snapshot");
+    }
+
+    Kind kind = static_cast<Kind>(data[5]);
+    if (kind == Kind::Incremental && base == nullptr)
+    {
+        throw std::runtime_error("incremental snapshot requires a base snapshot");
+    }
+
+    Snapshot snapshot;
+    if (kind == Kind::Incremental)
+    {
+        snapshot._pages = base->_pages;
+    }
+
+    snapshot._registers.PC = data[6] | data[7] << 8;
+    snapshot._registers.SP = data[8];
+    snapshot._registers.A = data[9];
+    snapshot._registers.X = data[10];
+    snapshot._registers.Y = data[11];
+    snapshot._registers.PS = data[12];
+    for (u32 shift = 0; shift < 64; shift += 8)
+    {
+        snapshot._cycles |= static_cast<u64>(data[13 + shift / 8]) << shift;
+    }
+
+    u32 pages = data[21] | data[22] << 8;
+    if (data.size() != header + pages * (1 + Memory::PageSize))
+    {
+        throw std::runtime_error("truncated snapshot");
+    }
+
+    for (u64 offset = header; offset < data.size(); offset += 1 + Memory::PageSize)
+    {
+        auto page = std::make_shared<Memory::Page>();
+        std::copy_n(data.begin() + offset + 1, Memory::PageSize, page->begin());
+        snapshot._pages[data[offset]] = std::move(page);
+    }
+
+    return snapshot;
+}
+
+auto Snapshot::GetRegisters() const -> Registers
+{
+    return _registers;
+}
+
+auto Snapshot::GetCycles() const -> u64
+{
+    return _cycles;
+}
+
+auto Snapshot::GetPage(u8 page) const -> const Memory::Page*
+{
+    static const Memory::Page zero = {};
+    return _pages[page] != nullptr ? _pages[page].get() : &zero;
+}
@@ -0,0 +1,115 @@
+#include <threadpool.hh>
+
+ThreadPool::ThreadPool(u32 threads) : _queued(0), _pending(0), _next(0), _stopping(false)
+{
+    if (threads == 0)
+    {
+        threads = 1;
+    }
+
+    for (u32 index = 0; index < threads; index++)
+    {
+        _queues.push_back(std::make_unique<Queue>());
+    }
+
+    for (u32 index = 0; index < threads; index++)
+    {
+        _threads.emplace_back([this, index] { Loop(index); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+    }
+
+    _wake.notify_all();
+    for (std::thread& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+auto ThreadPool::Submit(std::function<void()> task) -> void
+{
+    Queue& queue = *_queues[_next++ % _queues.size()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    _pending++;
+    {
+        std::lock_guard lock(_mutex);
+        _queued++;
+    }
+    _wake.notify_one();
+}
+
+auto ThreadPool::Wait() -> void
+{
+    std::unique_lock lock(_mutex);
+    _idle.wait(lock, [this] { return _pending == 0; });
+}
+
+auto ThreadPool::GetThreadCount() const -> u32
+{
+    return _threads.size();
+}
+
+auto ThreadPool::Loop(u32 index) -> void
+{
+    while (true)
+    {
+        std::function<void()> task;
+        if (Pop(index, task))
+        {
+            task();
+            if (--_pending == 0)
+            {
+                std::lock_guard lock(_mutex);
+                _idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock(_mutex);
+        _wake.wait(lock, [this] { return _stopping || _queued > 0; });
+        if (_stopping && _queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+auto ThreadPool::Pop(u32 index, std::function<void()>& task) -> bool
+{
+    {
+        Queue& queue = *_queues[index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            _queued--;
+            return true;
+        }
+    }
+
+    for (u32 offset = 1; offset < _queues.size(); offset++)
+    {
+        Queue& victim = *_queues[(index + offset) % _queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            _queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
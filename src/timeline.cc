@@ -0,0 +1,222 @@
+#include <timeline.hh>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+Timeline::Timeline(CPU& cpu, Memory& memory, Variant variant, u64 interval) : _cpu(cpu), _memory(memory), _variant(variant), _interval(interval), _position(0), _end(0)
+{
+    if (interval == 0)
+    {
+        throw std::runtime_error("checkpoint interval must not be zero");
+    }
+    _checkpoints.push_back({ 0, Snapshot::Capture(cpu, memory) });
+}
+
+auto Timeline::Run(u64 instructions, u64 cycles) -> RunResult
+{
+    return Record(instructions, cycles, nullptr);
+}
+
+auto Timeline::Run(u64 instructions, u64 cycles, Breakpoints& breakpoints) -> RunResult
+{
+    return Record(instructions, cycles, &breakpoints);
+}
+
+auto Timeline::Commit() -> void
+{
+    while (!_checkpoints.empty() && _checkpoints.back().position >= _position)
+    {
+        _checkpoints.pop_back();
+    }
+    _checkpoints.push_back({ _position, Snapshot::Capture(_cpu, _memory) });
+    _end = _position;
+}
+
+auto Timeline::Seek(u64 position) -> void
+{
+    if (position > _end)
+    {
+        throw std::out_of_range("position is beyond the recorded history");
+    }
+
+    u64 index = Find(position);
+    if (position < _position || _checkpoints[index].position > _position)
+    {
+        Restore(index);
+    }
+
+    if (position > _position)
+    {
+        _position += Advance(position - _position, std::numeric_limits<u64>::max(), nullptr).instructions;
+        if (_position != position)
+        {
+            throw std::runtime_error("replay diverged from the recorded history");
+        }
+    }
+}
+
+auto Timeline::ReverseStep(u64 count) -> bool
+{
+    if (_position == 0)
+    {
+        return false;
+    }
+    Seek(_position - std::min(count, _position));
+    return true;
+}
+
+auto Timeline::ReverseContinue(Breakpoints& breakpoints) -> bool
+{
+    std::optional<u64> hit = Search(breakpoints, _position, std::nullopt);
+    Seek(hit.value_or(0));
+    return hit.has_value();
+}
+
+auto Timeline::LastWrite(u16 address) -> std::optional<u64>
+{
+    Breakpoints watch;
+    watch.Watch(address);
+
+    std::optional<u8> page;
+    if ((address >> 8) >= Memory::DirectPageCount && !_memory.IsDevice(address >> 8))
+    {
+        page = address >> 8;
+    }
+
+    u64 position = _position;
+    std::optional<u64> hit = Search(watch, position, page);
+    Seek(position);
+    return hit;
+}
+
+auto Timeline::GetPosition() const -> u64
+{
+    return _position;
+}
+
+auto Timeline::GetEnd() const -> u64
+{
+    return _end;
+}
+
+auto Timeline::GetCheckpointCount() const -> u64
+{
+    return _checkpoints.size();
+}
+
+auto Timeline::Record(u64 instructions, u64 cycles, Breakpoints* breakpoints) -> RunResult
+{
+    while (_checkpoints.back().position > _position)
+    {
+        _checkpoints.pop_back();
+    }
+
+    RunResult total = { StopReason::InstructionLimit, 0, 0 };
+    while (true)
+    {
+        u64 next = _checkpoints.back().snapshot.GetCycles() + _interval;
+        if (_cpu.GetCycles() >= next)
+        {
+            _checkpoints.push_back({ _position, Snapshot::Capture(_cpu, _memory) });
+            continue;
+        }
+
+        if (breakpoints != nullptr && total.instructions != 0 && breakpoints->IsSet(_cpu.GetRegisters().PC))
+        {
+            total.reason = StopReason::Breakpoint;
+            break;
+        }
+
+        RunResult result = Advance(instructions - total.instructions, std::min(cycles - total.cycles, next - _cpu.GetCycles()), breakpoints);
+        total.instructions += result.instructions;
+        total.cycles += result.cycles;
+        _position += result.instructions;
+        if (result.reason != StopReason::CycleLimit || total.cycles >= cycles)
+        {
+            total.reason = result.reason;
+            break;
+        }
+    }
+
+    _end = _position;
+    return total;
+}
+
+auto Timeline::Advance(u64 instructions, u64 cycles, Breakpoints* breakpoints) -> RunResult
+{
+    switch (_variant)
+    {
+        case Variant::Cmos:
+            return breakpoints != nullptr ? _cpu.RunFor<Variant::Cmos>(_memory, instructions, cycles, *breakpoints) : _cpu.RunFor<Variant::Cmos>(_memory, instructions, cycles);
+        case Variant::Strict:
+            return breakpoints != nullptr ? _cpu.RunFor<Variant::Strict>(_memory, instructions, cycles, *breakpoints) : _cpu.RunFor<Variant::Strict>(_memory, instructions, cycles);
+        default:
+            return breakpoints != nullptr ? _cpu.RunFor<Variant::Nmos>(_memory, instructions, cycles, *breakpoints) : _cpu.RunFor<Variant::Nmos>(_memory, instructions, cycles);
+    }
+}
+
+auto Timeline::Restore(u64 index) -> void
+{
+    _checkpoints[index].snapshot.Restore(_cpu, _memory);
+    _position = _checkpoints[index].position;
+}
+
+auto Timeline::Find(u64 position) const -> u64
+{
+    auto next = std::upper_bound(_checkpoints.begin(), _checkpoints.end(), position, [](u64 value, const Checkpoint& checkpoint) { return value < checkpoint.position; });
+    return next - _checkpoints.begin() - 1;
+}
+
+auto Timeline::Search(Breakpoints& breakpoints, u64 before, std::optional<u8> page) -> std::optional<u64>
+{
+    if (before == 0)
+    {
+        return std::nullopt;
+    }
+
+    for (u64 index = Find(before - 1) + 1; index-- > 0;)
+    {
+        bool last = index + 1 == _checkpoints.size();
+        if (page.has_value())
+        {
+            bool written = last ? _memory.GetDirtyPages()[*page] : _checkpoints[index].snapshot.GetPage(*page) != _checkpoints[index + 1].snapshot.GetPage(*page);
+            if (!written)
+            {
+                continue;
+            }
+        }
+
+        std::optional<u64> hit = Scan(index, last ? before : std::min(_checkpoints[index + 1].position, before), breakpoints);
+        if (hit.has_value())
+        {
+            return hit;
+        }
+    }
+    return std::nullopt;
+}
+
+auto Timeline::Scan(u64 index, u64 end, Breakpoints& breakpoints) -> std::optional<u64>
+{
+    Restore(index);
+
+    std::optional<u64> hit;
+    while (_position < end)
+    {
+        if (breakpoints.IsSet(_cpu.GetRegisters().PC))
+        {
+            hit = _position;
+        }
+
+        RunResult result = Advance(end - _position, std::numeric_limits<u64>::max(), &breakpoints);
+        _position += result.instructions;
+        if (result.reason == StopReason::Watchpoint)
+        {
+            hit = _position - 1;
+        }
+        else if (result.reason != StopReason::Breakpoint)
+        {
+            break;
+        }
+    }
+    return hit;
+}
@@ -0,0 +1,152 @@
+#include <trace.hh>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+Trace::Trace(u64 capacity) : _records(std::make_unique<TraceRecord[]>(std::bit_ceil(std::max<u64>(capacity, 1)))), _mask(std::bit_ceil(std::max<u64>(capacity, 1)) - 1), _head(0), _flushed(0), _file(nullptr), _header(false), _variant(Variant::Nmos)
+{
+}
+
+Trace::~Trace()
+{
+    Close();
+}
+
+auto Trace::Open(const std::filesystem::path& path) -> void
+{
+    Close();
+    _file = std::fopen(path.c_str(), "wb");
+    if (_file == nullptr)
+    {
+        throw std::runtime_error("cannot open " + path.string());
+    }
+    _header = false;
+    _flushed = _head.load(std::memory_order_relaxed);
+}
+
+auto Trace::Close() -> void
+{
+    if (_file != nullptr)
+    {
+        Flush();
+        std::fclose(_file);
+        _file = nullptr;
+    }
+}
+
+auto Trace::Flush() -> void
+{
+    if (_file == nullptr)
+    {
+        return;
+    }
+
+    if (!_header)
+    {
+        u8 variant = static_cast<u8>(_variant);
+        if (std::fwrite(Magic, sizeof(Magic), 1, _file) != 1 || std::fwrite(&variant, 1, 1, _file) != 1)
+        {
+            throw std::runtime_error("cannot write trace");
+        }
+        _header = true;
+    }
+
+    u64 head = _head.load(std::memory_order_relaxed);
+    _flushed = std::max(_flushed, head - std::min(head, _mask + 1));
+    while (_flushed != head)
+    {
+        u64 first = _flushed & _mask;
+        u64 count = std::min(head - _flushed, _mask + 1 - first);
+        if (std::fwrite(&_records[first], sizeof(TraceRecord), count, _file) != count)
+        {
+            throw std::runtime_error("cannot write trace");
+        }
+        _flushed += count;
+    }
+    std::fflush(_file);
+}
+
+auto Trace::Clear() -> void
+{
+    Flush();
+    _head.store(0, std::memory_order_release);
+    _flushed = 0;
+}
+
+auto Trace::GetCapacity() const -> u64
+{
+    return _mask + 1;
+}
+
+auto Trace::GetCount() const -> u64
+{
+    return _head.load(std::memory_order_acquire);
+}
+
+auto Trace::GetLast(u64 count) const -> std::vector<TraceRecord>
+{
+    u64 head = _head.load(std::memory_order_acquire);
+    u64 first = head - std::min({ count, head, _mask + 1 });
+
+    std::vector<TraceRecord> records;
+    records.reserve(head - first);
+    for (u64 index = first; index != head; index++)
+    {
+        records.push_back(_records[index & _mask]);
+    }
+
+    u64 latest = _head.load(std::memory_order_acquire);
+    if (latest - first > _mask + 1)
+    {
+        records.erase(records.begin(), records.begin() + std::min<u64>(latest - first - (_mask + 1), records.size()));
+    }
+    return records;
+}
+
+auto Trace::GetVariant() const -> Variant
+{
+    return _variant;
+}
+
+auto Trace::Load(const std::filesystem::path& path) -> std::vector<TraceRecord>
+{
+    Variant variant;
+    return Load(path, variant);
+}
+
+auto Trace::Load(const std::filesystem::path& path, Variant& variant) -> std::vector<TraceRecord>
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        throw std::runtime_error("cannot open " + path.string());
+    }
+
+    char magic[sizeof(Magic)];
+    if (std::fread(magic, sizeof(magic), 1, file) != 1 || !std::equal(magic, magic + sizeof(magic) - 1, Magic) || magic[sizeof(magic) - 1] < 0x01 || magic[sizeof(magic) - 1] > Magic[sizeof(Magic) - 1])
+    {
+        std::fclose(file);
+        throw std::runtime_error("not a trace file: " + path.string());
+    }
+
+    variant = Variant::Nmos;
+    if (magic[sizeof(magic) - 1] >= 0x02)
+    {
+        u8 value;
+        if (std::fread(&value, 1, 1, file) != 1 || value > static_cast<u8>(Variant::Strict))
+        {
+            std::fclose(file);
+            throw std::runtime_error("invalid trace variant: " + path.string());
+        }
+        variant = static_cast<Variant>(value);
+    }
+
+    std::vector<TraceRecord> records;
+    TraceRecord buffer[0x1000];
+    while (u64 count = std::fread(buffer, sizeof(TraceRecord), std::size(buffer), file))
+    {
+        records.insert(records.end(), buffer, buffer + count);
+    }
+    std::fclose(file);
+    return records;
+}
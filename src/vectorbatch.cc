@@ -0,0 +1,983 @@
+#include <vectorbatch.hh>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+    template <typename T, u32 lanes>
+    struct Vector
+    {
+        typedef T Type __attribute__((vector_size(lanes * sizeof(T))));
+    };
+
+    template <typename To, typename From>
+    inline auto Convert(const From& vector) -> To
+    {
+        return __builtin_convertvector(vector, To);
+    }
+
+    template <typename T, typename Mask>
+    inline auto Select(const Mask& mask, const T& taken, const T& other) -> T
+    {
+        return (taken & (T)mask) | (other & ~(T)mask);
+    }
+
+    template <typename Function>
+    inline auto ForEach(u32 bits, Function function) -> void
+    {
+        for (; bits != 0; bits &= bits - 1)
+        {
+            function(std::countr_zero(bits));
+        }
+    }
+
+    auto ZeroPage(AddressingMode addressingMode) -> bool
+    {
+        return addressingMode == AddressingMode::ZeroPage || addressingMode == AddressingMode::ZeroPageX || addressingMode == AddressingMode::ZeroPageY;
+    }
+
+    auto SameCode(const Memory& leader, const Memory& memory, u16 pc, u8 length) -> bool
+    {
+        u16 last = pc + length - 1;
+        const u8* page = leader.GetReadPage(pc >> 8);
+        if (page != nullptr && page == memory.GetReadPage(pc >> 8) && leader.GetReadPage(last >> 8) == memory.GetReadPage(last >> 8))
+        {
+            return true;
+        }
+
+        for (u8 offset = 0; offset < length; offset++)
+        {
+            if (leader.Read(pc + offset) != memory.Read(pc + offset))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr u32 MaxCycles = []
+    {
+        u32 cycles = 0;
+        for (const Instruction& instruction : Instructions)
+        {
+            cycles = std::max<u32>(cycles, instruction.cycles);
+        }
+        return cycles + 2;
+    }();
+
+    auto Vectorized(const Instruction& instruction) -> bool
+    {
+        switch (instruction.operation)
+        {
+            case Operation::ADC:
+            case Operation::AND:
+            case Operation::ASL:
+            case Operation::BCC:
+            case Operation::BCS:
+            case Operation::BEQ:
+            case Operation::BIT:
+            case Operation::BMI:
+            case Operation::BNE:
+            case Operation::BPL:
+            case Operation::BVC:
+            case Operation::BVS:
+            case Operation::CLC:
+            case Operation::CLD:
+            case Operation::CLI:
+            case Operation::CLV:
+            case Operation::CMP:
+            case Operation::CPX:
+            case Operation::CPY:
+            case Operation::DEC:
+            case Operation::DEX:
+            case Operation::DEY:
+            case Operation::EOR:
+            case Operation::INC:
+            case Operation::INX:
+            case Operation::INY:
+            case Operation::LDA:
+            case Operation::LDX:
+            case Operation::LDY:
+            case Operation::LSR:
+            case Operation::ORA:
+            case Operation::PHA:
+            case Operation::PLA:
+            case Operation::ROL:
+            case Operation::ROR:
+            case Operation::RTS:
+            case Operation::SBC:
+            case Operation::SEC:
+            case Operation::SED:
+            case Operation::SEI:
+            case Operation::STA:
+            case Operation::STX:
+            case Operation::STY:
+            case Operation::TAX:
+            case Operation::TAY:
+            case Operation::TSX:
+            case Operation::TXA:
+            case Operation::TXS:
+            case Operation::TYA:
+                return true;
+            case Operation::JMP:
+            case Operation::JSR:
+                return instruction.addressingMode == AddressingMode::Absolute;
+            case Operation::NOP:
+                return instruction.addressingMode == AddressingMode::Implicit;
+            default:
+                return false;
+        }
+    }
+}
+
+template <u32 lanes>
+class VectorBatch::Group
+{
+  public:
+    explicit Group(std::span<const Job> jobs);
+
+    auto Run() -> void;
+    auto Collect(std::span<JobResult> results) -> void;
+
+  private:
+    using Bytes = typename Vector<u8, lanes>::Type;
+    using Words = typename Vector<u16, lanes>::Type;
+    using Counts = typename Vector<u32, lanes>::Type;
+    using ByteMask = typename Vector<std::make_signed_t<u8>, lanes>::Type;
+    using WordMask = typename Vector<std::make_signed_t<u16>, lanes>::Type;
+    using CountMask = typename Vector<std::make_signed_t<u32>, lanes>::Type;
+
+    static constexpr u32 NoPage = 0x100;
+    static constexpr u32 RebaseInterval = 1 << 20;
+    static constexpr u64 Window = 1u << 31;
+
+    Words PC = {};
+    Bytes SP = {};
+    Bytes A = {};
+    Bytes X = {};
+    Bytes Y = {};
+    Bytes PS = {};
+
+    Bytes _carry = {};
+    Bytes _overflow = {};
+    Bytes _zero = {};
+    Bytes _negative = {};
+
+    Counts _elapsed = {};
+    Counts _budget = {};
+    Counts _retired = {};
+    ByteMask _used = {};
+
+    std::array<u64, lanes> _start = {};
+    std::array<u64, lanes> _base = {};
+    std::array<u64, lanes> _remaining = {};
+    std::array<u64, lanes> _instructions = {};
+
+    std::array<Memory, lanes> _memories;
+    std::array<u8*, lanes> _zeroPages = {};
+    std::array<u8*, lanes> _stacks = {};
+    std::array<CPU, lanes> _cpus;
+    const CPU::Handler* _handlers;
+    u32 _count;
+
+    ByteMask _live = {};
+    u32 _liveBits = 0;
+    u32 _safe = 0;
+
+    u16 _pc = 0;
+    bool _converged = false;
+    u32 _verified = NoPage;
+
+    static auto Bits(const ByteMask& mask) -> u32;
+
+    auto Rebase() -> void;
+    auto Refresh() -> void;
+    auto Verify(u8 page) -> bool;
+    auto Step(u16 pc, const ByteMask& live, u32 bits, u32 liveBits) -> void;
+    auto Scalar(u32 bits) -> void;
+    auto Vectorize(const Instruction& instruction, u16 pc, u16 operand, const ByteMask& mask, u32 bits, bool all) -> void;
+
+    auto Load(u32 lane) -> void;
+    auto Save(u32 lane) -> void;
+
+    auto Address(AddressingMode addressingMode, u16 operand, u32 bits, Words& address) -> void;
+    auto Fetch(AddressingMode addressingMode, u16 operand, const ByteMask& mask, u32 bits, bool pageCrossCycle, Bytes& data, Words& address) -> void;
+    auto PageCross(const Words& address, const Bytes& index, const ByteMask& mask) -> void;
+    auto Scatter(AddressingMode addressingMode, const Words& address, const Bytes& data, u32 bits) -> void;
+    auto Store(AddressingMode addressingMode, const Words& address, const ByteMask& mask, u32 bits, const Bytes& data) -> void;
+
+    auto SetResult(const ByteMask& mask, const Bytes& result) -> void;
+    auto SetCarry(const ByteMask& mask, const ByteMask& carry) -> void;
+    auto Compare(const ByteMask& mask, const Bytes& left, const Bytes& right) -> void;
+};
+
+template <u32 lanes>
+VectorBatch::Group<lanes>::Group(std::span<const Job> jobs) : _handlers(CPU::Handlers(Variant::Nmos)), _count(jobs.size())
+{
+    for (u32 lane = 0; lane < _count; lane++)
+    {
+        _memories[lane].Map(*jobs[lane].image);
+        _zeroPages[lane] = _memories[lane].GetDirectPage(0x00);
+        _stacks[lane] = _memories[lane].GetDirectPage(0x01);
+
+        CPU& cpu = _cpus[lane];
+        Registers registers = cpu.GetRegisters();
+        registers.PC = jobs[lane].entry;
+        cpu.SetRegisters(registers);
+        _start[lane] = cpu._cycles;
+        _base[lane] = cpu._cycles;
+        _remaining[lane] = jobs[lane].cycles;
+        _budget[lane] = std::min(_remaining[lane], Window);
+        _used[lane] = -1;
+        Save(lane);
+    }
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Run() -> void
+{
+    for (u32 steps = 1; true; steps++)
+    {
+        if (steps % RebaseInterval == 0) [[unlikely]]
+        {
+            Rebase();
+        }
+
+        if (_safe == 0)
+        {
+            Refresh();
+            if (_liveBits == 0)
+            {
+                break;
+            }
+        }
+        _safe--;
+
+        if (_converged) [[likely]]
+        {
+            Step(_pc, _live, _liveBits, _liveBits);
+            continue;
+        }
+
+        u16 pc = 0xFFFF;
+        ForEach(_liveBits, [&](u32 lane)
+        {
+            pc = std::min<u16>(pc, PC[lane]);
+        });
+
+        ByteMask mask = _live & Convert<ByteMask>(PC == pc);
+        Step(pc, mask, Bits(mask), _liveBits);
+    }
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Collect(std::span<JobResult> results) -> void
+{
+    Rebase();
+    for (u32 lane = 0; lane < _count; lane++)
+    {
+        Load(lane);
+
+        const CPU& cpu = _cpus[lane];
+        JobResult& result = results[lane];
+        result.run.reason = cpu.BF != 0 ? cpu.GetStopReason() : StopReason::CycleLimit;
+        result.run.instructions = _instructions[lane];
+        result.run.cycles = _base[lane] - _start[lane];
+        result.registers = cpu.GetRegisters();
+        result.digest = Batch::Digest(_memories[lane]);
+    }
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Bits(const ByteMask& mask) -> u32
+{
+    u64 chunks[lanes / 8];
+    std::memcpy(chunks, &mask, sizeof(mask));
+
+    u32 bits = 0;
+    for (u32 chunk = 0; chunk < lanes / 8; chunk++)
+    {
+        bits |= static_cast<u32>(((chunks[chunk] & 0x8080808080808080) * 0x0002040810204081) >> 56) << chunk * 8;
+    }
+    return bits;
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Rebase() -> void
+{
+    for (u32 lane = 0; lane < _count; lane++)
+    {
+        _base[lane] += _elapsed[lane];
+        _remaining[lane] -= std::min<u64>(_remaining[lane], _elapsed[lane]);
+        _instructions[lane] += _retired[lane];
+        _budget[lane] = std::min(_remaining[lane], Window);
+    }
+    _elapsed = Counts{};
+    _retired = Counts{};
+    _safe = 0;
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Refresh() -> void
+{
+    _live = _used & ((PS & 0x10) == 0) & Convert<ByteMask>(_elapsed < _budget);
+    _liveBits = Bits(_live);
+
+    u32 slack = Window;
+    ForEach(_liveBits, [&](u32 lane)
+    {
+        slack = std::min(slack, _budget[lane] - _elapsed[lane]);
+    });
+    _safe = std::max<u32>(1, slack / MaxCycles);
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Verify(u8 page) -> bool
+{
+    const u8* data = _memories[0].GetReadPage(page);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    for (u32 lane = 1; lane < _count; lane++)
+    {
+        if (_memories[lane].GetReadPage(page) != data)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Step(u16 pc, const ByteMask& live, u32 bits, u32 liveBits) -> void
+{
+    ByteMask mask = live;
+    const Memory& leader = _memories[std::countr_zero(bits)];
+    const Instruction& instruction = Instructions[leader.Read(pc)];
+    u8 length = Length(instruction.addressingMode);
+
+    u16 operand = 0;
+    if (length > 1)
+    {
+        operand = leader.Read(pc + 1);
+    }
+    if (length > 2)
+    {
+        operand |= leader.Read(static_cast<u16>(pc + 2)) << 8;
+    }
+
+    u8 first = pc >> 8;
+    u8 last = static_cast<u16>(pc + length - 1) >> 8;
+    if (first != _verified || last != _verified) [[unlikely]]
+    {
+        if (first == last && Verify(first))
+        {
+            _verified = first;
+        }
+        else
+        {
+            ForEach(bits & (bits - 1), [&](u32 lane)
+            {
+                if (!SameCode(leader, _memories[lane], pc, length))
+                {
+                    bits &= ~(1u << lane);
+                    mask[lane] = 0;
+                }
+            });
+        }
+    }
+
+    if (std::has_single_bit(bits) || !Vectorized(instruction))
+    {
+        return Scalar(bits);
+    }
+
+    if (instruction.operation == Operation::ADC || instruction.operation == Operation::SBC)
+    {
+        if (Bits(mask & ((PS & 0x08) != 0)) != 0) [[unlikely]]
+        {
+            return Scalar(bits);
+        }
+    }
+
+    Vectorize(instruction, pc, operand, mask, bits, bits == liveBits);
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Scalar(u32 bits) -> void
+{
+    ForEach(bits, [&](u32 lane)
+    {
+        CPU& cpu = _cpus[lane];
+        Memory& memory = _memories[lane];
+
+        Load(lane);
+        cpu.Bind(memory);
+        _handlers[memory.Read(cpu.PC++)](cpu, memory);
+        Save(lane);
+        _retired[lane]++;
+    });
+
+    _converged = false;
+    _verified = NoPage;
+    _safe = 0;
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Vectorize(const Instruction& instruction, u16 pc, u16 operand, const ByteMask& mask, u32 bits, bool all) -> void
+{
+    AddressingMode addressingMode = instruction.addressingMode;
+    u16 next = pc + Length(addressingMode);
+    WordMask words = Convert<WordMask>(mask);
+    CountMask counts = Convert<CountMask>(mask);
+
+    PC = Select(words, Words{} + next, PC);
+    _elapsed += (Counts)counts & instruction.cycles;
+    _retired += (Counts)counts & 1;
+
+    u16 target = next;
+    bool uniform = true;
+    auto branch = [&](const ByteMask& condition)
+    {
+        ByteMask taken = mask & condition;
+        u32 takenBits = Bits(taken);
+        if (takenBits == 0)
+        {
+            return;
+        }
+
+        u16 destination = next + static_cast<signed char>(operand);
+        u8 cycles = 1 + CPU::PageCrossed(next, destination);
+        PC = Select(Convert<WordMask>(taken), Words{} + destination, PC);
+        _elapsed += (Counts)Convert<CountMask>(taken) & cycles;
+        target = destination;
+        uniform = takenBits == bits;
+    };
+
+    Bytes data = {};
+    Words address = {};
+    switch (instruction.operation)
+    {
+        case Operation::ADC:
+        {
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            Bytes result = A + data + _carry;
+            SetCarry(mask, (result < A) | ((result == A) & (_carry != 0)));
+            _overflow = Select(mask, Bytes((~(A ^ data) & (A ^ result)) >> 7), _overflow);
+            A = Select(mask, result, A);
+            SetResult(mask, A);
+            break;
+        }
+        case Operation::AND:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            A = Select(mask, A & data, A);
+            SetResult(mask, A);
+            break;
+        case Operation::ASL:
+        {
+            Fetch(addressingMode, operand, mask, bits, false, data, address);
+            SetCarry(mask, (data & 0x80) != 0);
+            Bytes result = data << 1;
+            SetResult(mask, result);
+            Store(addressingMode, address, mask, bits, result);
+            break;
+        }
+        case Operation::BCC:
+            branch(_carry == 0);
+            break;
+        case Operation::BCS:
+            branch(_carry != 0);
+            break;
+        case Operation::BEQ:
+            branch(_zero == 0);
+            break;
+        case Operation::BIT:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            _zero = Select(mask, A & data, _zero);
+            if (addressingMode != AddressingMode::Immediate)
+            {
+                _overflow = Select(mask, Bytes((data >> 6) & 0x01), _overflow);
+                _negative = Select(mask, data, _negative);
+            }
+            break;
+        case Operation::BMI:
+            branch((_negative & 0x80) != 0);
+            break;
+        case Operation::BNE:
+            branch(_zero != 0);
+            break;
+        case Operation::BPL:
+            branch((_negative & 0x80) == 0);
+            break;
+        case Operation::BVC:
+            branch(_overflow == 0);
+            break;
+        case Operation::BVS:
+            branch(_overflow != 0);
+            break;
+        case Operation::CLC:
+            _carry = Select(mask, Bytes{}, _carry);
+            break;
+        case Operation::CLD:
+            PS = Select(mask, Bytes(PS & 0xF7), PS);
+            break;
+        case Operation::CLI:
+            PS = Select(mask, Bytes(PS & 0xFB), PS);
+            break;
+        case Operation::CLV:
+            _overflow = Select(mask, Bytes{}, _overflow);
+            break;
+        case Operation::CMP:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            Compare(mask, A, data);
+            break;
+        case Operation::CPX:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            Compare(mask, X, data);
+            break;
+        case Operation::CPY:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            Compare(mask, Y, data);
+            break;
+        case Operation::DEC:
+        {
+            Fetch(addressingMode, operand, mask, bits, false, data, address);
+            Bytes result = data - 1;
+            SetResult(mask, result);
+            Store(addressingMode, address, mask, bits, result);
+            break;
+        }
+        case Operation::DEX:
+            X = Select(mask, Bytes(X - 1), X);
+            SetResult(mask, X);
+            break;
+        case Operation::DEY:
+            Y = Select(mask, Bytes(Y - 1), Y);
+            SetResult(mask, Y);
+            break;
+        case Operation::EOR:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            A = Select(mask, A ^ data, A);
+            SetResult(mask, A);
+            break;
+        case Operation::INC:
+        {
+            Fetch(addressingMode, operand, mask, bits, false, data, address);
+            Bytes result = data + 1;
+            SetResult(mask, result);
+            Store(addressingMode, address, mask, bits, result);
+            break;
+        }
+        case Operation::INX:
+            X = Select(mask, Bytes(X + 1), X);
+            SetResult(mask, X);
+            break;
+        case Operation::INY:
+            Y = Select(mask, Bytes(Y + 1), Y);
+            SetResult(mask, Y);
+            break;
+        case Operation::JMP:
+            PC = Select(words, Words{} + operand, PC);
+            target = operand;
+            break;
+        case Operation::JSR:
+        {
+            u16 link = next - 1;
+            ForEach(bits, [&](u32 lane)
+            {
+                _stacks[lane][SP[lane]] = link >> 8;
+                _stacks[lane][static_cast<u8>(SP[lane] - 1)] = link & 0xFF;
+            });
+            SP = Select(mask, Bytes(SP - 2), SP);
+            PC = Select(words, Words{} + operand, PC);
+            target = operand;
+            break;
+        }
+        case Operation::LDA:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            A = Select(mask, data, A);
+            SetResult(mask, A);
+            break;
+        case Operation::LDX:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            X = Select(mask, data, X);
+            SetResult(mask, X);
+            break;
+        case Operation::LDY:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            Y = Select(mask, data, Y);
+            SetResult(mask, Y);
+            break;
+        case Operation::LSR:
+        {
+            Fetch(addressingMode, operand, mask, bits, false, data, address);
+            SetCarry(mask, (data & 0x01) != 0);
+            Bytes result = data >> 1;
+            SetResult(mask, result);
+            Store(addressingMode, address, mask, bits, result);
+            break;
+        }
+        case Operation::NOP:
+            break;
+        case Operation::ORA:
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            A = Select(mask, A | data, A);
+            SetResult(mask, A);
+            break;
+        case Operation::PHA:
+            ForEach(bits, [&](u32 lane)
+            {
+                _stacks[lane][SP[lane]] = A[lane];
+            });
+            SP = Select(mask, Bytes(SP - 1), SP);
+            break;
+        case Operation::PLA:
+            SP = Select(mask, Bytes(SP + 1), SP);
+            ForEach(bits, [&](u32 lane)
+            {
+                A[lane] = _stacks[lane][SP[lane]];
+            });
+            SetResult(mask, A);
+            break;
+        case Operation::ROL:
+        {
+            Fetch(addressingMode, operand, mask, bits, false, data, address);
+            Bytes result = data << 1 | _carry;
+            SetCarry(mask, (data & 0x80) != 0);
+            SetResult(mask, result);
+            Store(addressingMode, address, mask, bits, result);
+            break;
+        }
+        case Operation::ROR:
+        {
+            Fetch(addressingMode, operand, mask, bits, false, data, address);
+            Bytes result = data >> 1 | _carry << 7;
+            SetCarry(mask, (data & 0x01) != 0);
+            SetResult(mask, result);
+            Store(addressingMode, address, mask, bits, result);
+            break;
+        }
+        case Operation::RTS:
+            ForEach(bits, [&](u32 lane)
+            {
+                u16 link = _stacks[lane][static_cast<u8>(SP[lane] + 1)];
+                link |= _stacks[lane][static_cast<u8>(SP[lane] + 2)] << 8;
+                PC[lane] = link + 1;
+            });
+            SP = Select(mask, Bytes(SP + 2), SP);
+            target = PC[std::countr_zero(bits)];
+            ForEach(bits, [&](u32 lane)
+            {
+                uniform &= PC[lane] == target;
+            });
+            break;
+        case Operation::SBC:
+        {
+            Fetch(addressingMode, operand, mask, bits, true, data, address);
+            Bytes result = A - data - 1 + _carry;
+            SetCarry(mask, (A > data) | ((A == data) & (_carry != 0)));
+            _overflow = Select(mask, Bytes(((A ^ result) & (A ^ data)) >> 7), _overflow);
+            A = Select(mask, result, A);
+            SetResult(mask, A);
+            break;
+        }
+        case Operation::SEC:
+            _carry = Select(mask, Bytes{} + 1, _carry);
+            break;
+        case Operation::SED:
+            PS = Select(mask, Bytes(PS | 0x08), PS);
+            break;
+        case Operation::SEI:
+            PS = Select(mask, Bytes(PS | 0x04), PS);
+            break;
+        case Operation::STA:
+            Address(addressingMode, operand, bits, address);
+            Scatter(addressingMode, address, A, bits);
+            break;
+        case Operation::STX:
+            Address(addressingMode, operand, bits, address);
+            Scatter(addressingMode, address, X, bits);
+            break;
+        case Operation::STY:
+            Address(addressingMode, operand, bits, address);
+            Scatter(addressingMode, address, Y, bits);
+            break;
+        case Operation::TAX:
+            X = Select(mask, A, X);
+            SetResult(mask, X);
+            break;
+        case Operation::TAY:
+            Y = Select(mask, A, Y);
+            SetResult(mask, Y);
+            break;
+        case Operation::TSX:
+            X = Select(mask, SP, X);
+            SetResult(mask, X);
+            break;
+        case Operation::TXA:
+            A = Select(mask, X, A);
+            SetResult(mask, A);
+            break;
+        case Operation::TXS:
+            SP = Select(mask, X, SP);
+            break;
+        case Operation::TYA:
+            A = Select(mask, Y, A);
+            SetResult(mask, A);
+            break;
+        default:
+            break;
+    }
+
+    _pc = target;
+    _converged = all && uniform;
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Load(u32 lane) -> void
+{
+    CPU& cpu = _cpus[lane];
+    cpu.PC = PC[lane];
+    cpu.SP = SP[lane];
+    cpu.A = A[lane];
+    cpu.X = X[lane];
+    cpu.Y = Y[lane];
+    cpu.PS = PS[lane];
+    cpu._carry = _carry[lane];
+    cpu._overflow = _overflow[lane];
+    cpu._zero = _zero[lane];
+    cpu._negative = _negative[lane];
+    cpu._cycles = _base[lane] + _elapsed[lane];
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Save(u32 lane) -> void
+{
+    const CPU& cpu = _cpus[lane];
+    PC[lane] = cpu.PC;
+    SP[lane] = cpu.SP;
+    A[lane] = cpu.A;
+    X[lane] = cpu.X;
+    Y[lane] = cpu.Y;
+    PS[lane] = cpu.PS;
+    _carry[lane] = cpu._carry;
+    _overflow[lane] = cpu._overflow;
+    _zero[lane] = cpu._zero;
+    _negative[lane] = cpu._negative;
+    _elapsed[lane] = cpu._cycles - _base[lane];
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Address(AddressingMode addressingMode, u16 operand, u32 bits, Words& address) -> void
+{
+    switch (addressingMode)
+    {
+        case AddressingMode::ZeroPageX:
+            address = Convert<Words>(Bytes(X + static_cast<u8>(operand)));
+            break;
+        case AddressingMode::ZeroPageY:
+            address = Convert<Words>(Bytes(Y + static_cast<u8>(operand)));
+            break;
+        case AddressingMode::AbsoluteX:
+            address = operand + Convert<Words>(X);
+            break;
+        case AddressingMode::AbsoluteY:
+            address = operand + Convert<Words>(Y);
+            break;
+        case AddressingMode::IndirectX:
+            ForEach(bits, [&](u32 lane)
+            {
+                u8 pointer = operand + X[lane];
+                address[lane] = _zeroPages[lane][pointer] | _zeroPages[lane][static_cast<u8>(pointer + 1)] << 8;
+            });
+            break;
+        case AddressingMode::IndirectY:
+            ForEach(bits, [&](u32 lane)
+            {
+                u16 base = _zeroPages[lane][static_cast<u8>(operand)] | _zeroPages[lane][static_cast<u8>(operand + 1)] << 8;
+                address[lane] = base + Y[lane];
+            });
+            break;
+        default:
+            address = Words{} + operand;
+            break;
+    }
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Fetch(AddressingMode addressingMode, u16 operand, const ByteMask& mask, u32 bits, bool pageCrossCycle, Bytes& data, Words& address) -> void
+{
+    if (addressingMode == AddressingMode::Immediate)
+    {
+        data = Bytes{} + static_cast<u8>(operand);
+        return;
+    }
+
+    if (addressingMode == AddressingMode::Accumulator)
+    {
+        data = A;
+        return;
+    }
+
+    Address(addressingMode, operand, bits, address);
+    if (pageCrossCycle && addressingMode == AddressingMode::AbsoluteX)
+    {
+        PageCross(address, X, mask);
+    }
+    else if (pageCrossCycle && (addressingMode == AddressingMode::AbsoluteY || addressingMode == AddressingMode::IndirectY))
+    {
+        PageCross(address, Y, mask);
+    }
+
+    if (ZeroPage(addressingMode))
+    {
+        ForEach(bits, [&](u32 lane)
+        {
+            data[lane] = _zeroPages[lane][address[lane]];
+        });
+        return;
+    }
+
+    ForEach(bits, [&](u32 lane)
+    {
+        data[lane] = _memories[lane].Read(address[lane]);
+    });
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::PageCross(const Words& address, const Bytes& index, const ByteMask& mask) -> void
+{
+    WordMask crossed = ((address ^ (address - Convert<Words>(index))) >> 8) != 0;
+    _elapsed += (Counts)Convert<CountMask>(crossed & Convert<WordMask>(mask)) & 1;
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Scatter(AddressingMode addressingMode, const Words& address, const Bytes& data, u32 bits) -> void
+{
+    if (ZeroPage(addressingMode))
+    {
+        ForEach(bits, [&](u32 lane)
+        {
+            _zeroPages[lane][address[lane]] = data[lane];
+        });
+        return;
+    }
+
+    ForEach(bits, [&](u32 lane)
+    {
+        if (address[lane] >> 8 == _verified)
+        {
+            _verified = NoPage;
+        }
+        _memories[lane].Write(address[lane], data[lane]);
+    });
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Store(AddressingMode addressingMode, const Words& address, const ByteMask& mask, u32 bits, const Bytes& data) -> void
+{
+    if (addressingMode == AddressingMode::Accumulator)
+    {
+        A = Select(mask, data, A);
+        return;
+    }
+
+    Scatter(addressingMode, address, data, bits);
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::SetResult(const ByteMask& mask, const Bytes& result) -> void
+{
+    _zero = Select(mask, result, _zero);
+    _negative = Select(mask, result, _negative);
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::SetCarry(const ByteMask& mask, const ByteMask& carry) -> void
+{
+    _carry = Select(mask, Bytes((Bytes)carry & 0x01), _carry);
+}
+
+template <u32 lanes>
+auto VectorBatch::Group<lanes>::Compare(const ByteMask& mask, const Bytes& left, const Bytes& right) -> void
+{
+    SetCarry(mask, left >= right);
+    SetResult(mask, Bytes(left - right));
+}
+
+VectorBatch::VectorBatch(u32 lanes, u32 threads) : _pool(threads), _lanes(lanes)
+{
+    if (lanes != 8 && lanes != 16 && lanes != 32)
+    {
+        throw std::runtime_error("vector batch lanes must be 8, 16 or 32");
+    }
+}
+
+auto VectorBatch::Run(const std::vector<Job>& jobs) -> std::vector<JobResult>
+{
+    std::vector<JobResult> results(jobs.size());
+
+    u64 groups = (jobs.size() + _lanes - 1) / _lanes;
+    u64 chunk = std::max<u64>(1, groups / (_pool.GetThreadCount() * 16)) * _lanes;
+    for (u64 first = 0; first < jobs.size(); first += chunk)
+    {
+        u64 last = std::min<u64>(first + chunk, jobs.size());
+        u32 width = _lanes;
+        _pool.Submit([&jobs, &results, first, last, width]
+        {
+            for (u64 index = first; index < last; index += width)
+            {
+                u64 count = std::min<u64>(width, last - index);
+                Execute(std::span(jobs).subspan(index, count), std::span(results).subspan(index, count));
+            }
+        });
+    }
+
+    _pool.Wait();
+    return results;
+}
+
+auto VectorBatch::GetLaneCount() const -> u32
+{
+    return _lanes;
+}
+
+auto VectorBatch::GetThreadCount() const -> u32
+{
+    return _pool.GetThreadCount();
+}
+
+auto VectorBatch::Execute(std::span<const Job> jobs, std::span<JobResult> results) -> void
+{
+    for (u64 first = 0; first < jobs.size(); first += MaxLanes)
+    {
+        u64 count = std::min<u64>(MaxLanes, jobs.size() - first);
+        std::span<const Job> group = jobs.subspan(first, count);
+        std::span<JobResult> output = results.subspan(first, count);
+
+        if (count <= 8)
+        {
+            auto lanes = std::make_unique<Group<8>>(group);
+            lanes->Run();
+            lanes->Collect(output);
+        }
+        else if (count <= 16)
+        {
+            auto lanes = std::make_unique<Group<16>>(group);
+            lanes->Run();
+            lanes->Collect(output);
+        }
+        else
+        {
+            auto lanes = std::make_unique<Group<32>>(group);
+            lanes->Run();
+            lanes->Collect(output);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <blockcache.hh>
+#include <cpu.hh>
+#include <device.hh>
+#include <interrupt.hh>
+#include <lockstep.hh>
+#include <memory.hh>
+#include "workloads.hh"
+
+static constexpr u8 InterruptProgram[] = {
+    0x58,             // 0600: CLI
+    0xA2, 0x00,       // 0601: LDX #$00
+    0xE8,             // 0603: INX
+    0xE8,             // 0604: INX
+    0x78,             // 0605: SEI
+    0xC8,             // 0606: INY
+    0xC8,             // 0607: INY
+    0x58,             // 0608: CLI
+    0xE8,             // 0609: INX
+    0x8A,             // 060A: TXA
+    0x29, 0x0C,       // 060B: AND #$0C
+    0xD0, 0x03,       // 060D: BNE $0612
+    0x8D, 0x01, 0xD0, // 060F: STA $D001
+    0xE8,             // 0612: INX
+    0xE6, 0x21,       // 0613: INC $21
+    0x4C, 0x03, 0x06, // 0615: JMP $0603
+};
+
+static constexpr u8 InterruptHandler[] = {
+    0x48,             // 0700: PHA
+    0x8D, 0x00, 0xD0, // 0701: STA $D000
+    0xE6, 0x20,       // 0704: INC $20
+    0x68,             // 0706: PLA
+    0x40,             // 0707: RTI
+};
+
+static constexpr u8 InterruptVector[] = { 0x00, 0x07 };
+
+static constexpr u64 TimerPeriod = 997;
+
+// Gives each CPU a timer that raises an IRQ every TimerPeriod cycles, and a
+// device at $D000 whose first register acknowledges it and whose second one
+// raises it from software, so the IRQ line also changes in the middle of a block.
+struct Machine
+{
+    InterruptController interrupts;
+    CallbackDevice device;
+    std::function<void(u64)> timer;
+    CPU* cpu = nullptr;
+
+    Machine()
+        : device(nullptr, [this](u16 address, u8 data)
+                 {
+                     (void)data;
+                     interrupts.SetIrq(0, address != 0xD000);
+                 })
+    {
+        timer = [this](u64 cycle)
+        {
+            interrupts.SetIrq(0, true);
+            interrupts.Schedule(cycle + TimerPeriod, timer);
+        };
+    }
+};
+
+static auto Attach(std::shared_ptr<Machine> machine, Engine engine) -> Engine
+{
+    return [machine, engine](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        if (machine->cpu != &cpu)
+        {
+            machine->cpu = &cpu;
+            memory.Attach(0xD000, 0xD001, machine->device);
+            cpu.Attach(machine->interrupts);
+            machine->interrupts.Schedule(TimerPeriod, machine->timer);
+        }
+        return engine(cpu, memory, instructions);
+    };
+}
+
+static auto Check(const char* program, const char* engine, u64 stride, const std::optional<Divergence>& divergence) -> bool
+{
+    if (!divergence.has_value())
+    {
+        std::printf("%-16s %-12s stride %-5llu ok\n", program, engine, stride);
+        return true;
+    }
+
+    std::printf("%-16s %-12s stride %-5llu diverges after %llu instructions: PC $%04X/$%04X, A $%02X/$%02X, X $%02X/$%02X, Y $%02X/$%02X, PS $%02X/$%02X, cycles %llu/%llu", program, engine, stride, divergence->instructions, divergence->expected.PC, divergence->actual.PC, divergence->expected.A, divergence->actual.A, divergence->expected.X, divergence->actual.X, divergence->expected.Y, divergence->actual.Y, divergence->expected.PS, divergence->actual.PS, divergence->expectedCycles, divergence->actualCycles);
+    if (divergence->address.has_value())
+    {
+        std::printf(", memory differs at $%04X", *divergence->address);
+    }
+    std::printf("\n");
+    return false;
+}
+
+auto main() -> int
+{
+    Engine interpreter = [](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        return cpu.RunInstructions(memory, instructions);
+    };
+
+    BlockCache cache;
+    Engine blocks = [&cache](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        return cache.RunInstructions(cpu, memory, instructions);
+    };
+
+    BlockCache jit;
+    jit.SetJitEnabled(true);
+    Engine compiled = [&jit](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        return jit.RunInstructions(cpu, memory, instructions);
+    };
+
+    std::vector<std::pair<const char*, Engine>> candidates = { { "blocks", blocks } };
+    if (jit.IsJitEnabled())
+    {
+        candidates.push_back({ "jit", compiled });
+    }
+
+    bool passed = true;
+    for (const auto& [name, candidate] : candidates)
+    {
+        for (const Workload& workload : Workloads)
+        {
+            Lockstep lockstep(interpreter, candidate, 1000);
+            passed &= Check(workload.name, name, 1000, lockstep.Run(Image(0x0600, workload.program), 0x0600, std::numeric_limits<u64>::max()));
+        }
+
+        Image image(0x0600, InterruptProgram);
+        image.Write(0x0700, InterruptHandler);
+        image.Write(CPU::IrqVector, InterruptVector);
+        for (u64 stride : { 1000, 7, 1 })
+        {
+            Lockstep lockstep(Attach(std::make_shared<Machine>(), interpreter), Attach(std::make_shared<Machine>(), candidate), stride);
+            passed &= Check("interrupts", name, stride, lockstep.Run(image, 0x0600, 200000));
+        }
+    }
+
+    return passed ? 0 : 1;
+}
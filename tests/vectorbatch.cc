@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <batch.hh>
+#include <memory.hh>
+#include <vectorbatch.hh>
+#include "workloads.hh"
+
+// Gives each lane its own inputs: a different first immediate operand for
+// every fourth lane, so lanes disagree on code bytes, different data in the
+// zero page and at $2000, and a different cycle budget, so lanes split up,
+// stop at different points and leave through both BRK and the cycle limit.
+static auto MakeJobs(const Workload& workload, u32 count) -> std::vector<Job>
+{
+    std::vector<Job> jobs;
+    for (u32 lane = 0; lane < count; lane++)
+    {
+        std::vector<u8> program(workload.program.begin(), workload.program.end());
+        program[1] += lane % 4;
+
+        std::vector<u8> data(Memory::PageSize);
+        for (u32 index = 0; index < data.size(); index++)
+        {
+            data[index] = static_cast<u8>(index * 7 + lane * 31);
+        }
+
+        auto image = std::make_shared<Image>(0x0600, program);
+        image->Write(0x0010, std::span(data).first(0x10));
+        image->Write(0x00E0, std::span(data).first(0x08));
+        image->Write(0x2000, data);
+
+        u64 cycles = lane % 3 == 0 ? std::numeric_limits<u64>::max() : 50000 + lane * 7919;
+        jobs.push_back({ image, 0x0600, cycles });
+    }
+    return jobs;
+}
+
+static auto Check(const char* program, u32 lanes, u32 lane, const JobResult& expected, const JobResult& actual) -> bool
+{
+    if (expected.run.reason == actual.run.reason && expected.run.instructions == actual.run.instructions && expected.run.cycles == actual.run.cycles && expected.registers.PC == actual.registers.PC && expected.registers.SP == actual.registers.SP && expected.registers.A == actual.registers.A && expected.registers.X == actual.registers.X && expected.registers.Y == actual.registers.Y && expected.registers.PS == actual.registers.PS && expected.digest == actual.digest)
+    {
+        return true;
+    }
+
+    std::printf("%-16s %2u lanes, lane %-2u differs: reason %d/%d, instructions %llu/%llu, cycles %llu/%llu, PC $%04X/$%04X, SP $%02X/$%02X, A $%02X/$%02X, X $%02X/$%02X, Y $%02X/$%02X, PS $%02X/$%02X, digest %016llX/%016llX\n", program, lanes, lane, static_cast<int>(expected.run.reason), static_cast<int>(actual.run.reason), expected.run.instructions, actual.run.instructions, expected.run.cycles, actual.run.cycles, expected.registers.PC, actual.registers.PC, expected.registers.SP, actual.registers.SP, expected.registers.A, actual.registers.A, expected.registers.X, actual.registers.X, expected.registers.Y, actual.registers.Y, expected.registers.PS, actual.registers.PS, expected.digest, actual.digest);
+    return false;
+}
+
+auto main() -> int
+{
+    bool passed = true;
+    for (const Workload& workload : Workloads)
+    {
+        for (u32 lanes : { 8u, 16u, 32u })
+        {
+            std::vector<Job> jobs = MakeJobs(workload, lanes);
+            std::vector<JobResult> results(jobs.size());
+            VectorBatch::Execute(jobs, results);
+
+            bool matched = true;
+            for (u32 lane = 0; lane < lanes; lane++)
+            {
+                matched &= Check(workload.name, lanes, lane, Batch::Execute(jobs[lane]), results[lane]);
+            }
+
+            if (matched)
+            {
+                std::printf("%-16s %2u lanes ok\n", workload.name, lanes);
+            }
+            passed &= matched;
+        }
+    }
+
+    return passed ? 0 : 1;
+}
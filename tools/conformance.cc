@@ -0,0 +1,558 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <blockcache.hh>
+#include <cpu.hh>
+#include <disassembler.hh>
+#include <interrupt.hh>
+#include <loader.hh>
+#include <lockstep.hh>
+#include <memory.hh>
+
+struct Json
+{
+    enum class Kind
+    {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    Kind kind = Kind::Null;
+    long long number = 0;
+    std::string text;
+    std::vector<Json> items;
+    std::vector<std::pair<std::string, Json>> members;
+
+    auto operator[](std::string_view name) const -> const Json&
+    {
+        for (const auto& [key, value] : members)
+        {
+            if (key == name)
+            {
+                return value;
+            }
+        }
+        throw std::runtime_error("missing JSON member " + std::string(name));
+    }
+};
+
+class JsonParser
+{
+  public:
+    explicit JsonParser(std::span<const u8> text) : _text(text), _position(0)
+    {
+    }
+
+    auto Parse() -> Json
+    {
+        Json value = Value();
+        Skip();
+        if (_position != _text.size())
+        {
+            throw std::runtime_error("trailing characters after JSON value");
+        }
+        return value;
+    }
+
+  private:
+    std::span<const u8> _text;
+    u64 _position;
+
+    auto Skip() -> void
+    {
+        while (_position < _text.size() && (_text[_position] == ' ' || _text[_position] == '\t' || _text[_position] == '\n' || _text[_position] == '\r'))
+        {
+            _position++;
+        }
+    }
+
+    auto Peek() -> u8
+    {
+        Skip();
+        if (_position == _text.size())
+        {
+            throw std::runtime_error("unexpected end of JSON");
+        }
+        return _text[_position];
+    }
+
+    auto Expect(u8 character) -> void
+    {
+        if (Peek() != character)
+        {
+            throw std::runtime_error("unexpected character in JSON at offset " + std::to_string(_position));
+        }
+        _position++;
+    }
+
+    auto Literal(std::string_view literal) -> void
+    {
+        if (_text.size() - _position < literal.size() || !std::equal(literal.begin(), literal.end(), _text.begin() + _position))
+        {
+            throw std::runtime_error("invalid JSON literal at offset " + std::to_string(_position));
+        }
+        _position += literal.size();
+    }
+
+    auto Value() -> Json
+    {
+        Json value;
+        u8 character = Peek();
+        if (character == '{')
+        {
+            value.kind = Json::Kind::Object;
+            _position++;
+            if (Peek() == '}')
+            {
+                _position++;
+                return value;
+            }
+            do
+            {
+                std::string key = String();
+                Expect(':');
+                value.members.emplace_back(std::move(key), Value());
+            } while (Peek() == ',' && ++_position);
+            Expect('}');
+        }
+        else if (character == '[')
+        {
+            value.kind = Json::Kind::Array;
+            _position++;
+            if (Peek() == ']')
+            {
+                _position++;
+                return value;
+            }
+            do
+            {
+                value.items.push_back(Value());
+            } while (Peek() == ',' && ++_position);
+            Expect(']');
+        }
+        else if (character == '"')
+        {
+            value.kind = Json::Kind::String;
+            value.text = String();
+        }
+        else if (character == 't' || character == 'f')
+        {
+            value.kind = Json::Kind::Boolean;
+            value.number = character == 't';
+            Literal(character == 't' ? "true" : "false");
+        }
+        else if (character == 'n')
+        {
+            Literal("null");
+        }
+        else
+        {
+            value.kind = Json::Kind::Number;
+            bool negative = character == '-';
+            _position += negative;
+            if (_position == _text.size() || _text[_position] < '0' || _text[_position] > '9')
+            {
+                throw std::runtime_error("invalid JSON number at offset " + std::to_string(_position));
+            }
+            while (_position < _text.size() && _text[_position] >= '0' && _text[_position] <= '9')
+            {
+                value.number = value.number * 10 + (_text[_position++] - '0');
+            }
+            value.number = negative ? -value.number : value.number;
+        }
+        return value;
+    }
+
+    auto String() -> std::string
+    {
+        Expect('"');
+        std::string text;
+        while (_position < _text.size() && _text[_position] != '"')
+        {
+            u8 character = _text[_position++];
+            if (character == '\\' && _position < _text.size())
+            {
+                character = _text[_position++];
+                if (character == 'u')
+                {
+                    _position += 4;
+                    character = '?';
+                }
+                else if (character == 'n')
+                {
+                    character = '\n';
+                }
+                else if (character == 't')
+                {
+                    character = '\t';
+                }
+            }
+            text.push_back(character);
+        }
+        Expect('"');
+        return text;
+    }
+};
+
+struct Engines
+{
+    Variant variant;
+    BlockCache blocks;
+    BlockCache jit;
+
+    Engines(Variant variant) : variant(variant), blocks(variant), jit(variant)
+    {
+        blocks.SetJitEnabled(false);
+        jit.SetJitEnabled(true);
+    }
+
+    auto Get(std::string_view name) -> Engine
+    {
+        if (name == "interpreter")
+        {
+            switch (variant)
+            {
+                case Variant::Cmos:
+                    return [](CPU& cpu, Memory& memory, u64 instructions) { return cpu.RunInstructions<Variant::Cmos>(memory, instructions); };
+                case Variant::Strict:
+                    return [](CPU& cpu, Memory& memory, u64 instructions) { return cpu.RunInstructions<Variant::Strict>(memory, instructions); };
+                default:
+                    return [](CPU& cpu, Memory& memory, u64 instructions) { return cpu.RunInstructions<Variant::Nmos>(memory, instructions); };
+            }
+        }
+        if (name == "blocks")
+        {
+            return [this](CPU& cpu, Memory& memory, u64 instructions) { return blocks.RunInstructions(cpu, memory, instructions); };
+        }
+        if (name == "jit")
+        {
+            if (!jit.IsJitEnabled())
+            {
+                throw std::runtime_error("the JIT is not available in this build");
+            }
+            return [this](CPU& cpu, Memory& memory, u64 instructions) { return jit.RunInstructions(cpu, memory, instructions); };
+        }
+        throw std::runtime_error("unknown engine " + std::string(name));
+    }
+};
+
+struct Options
+{
+    std::string engine = "interpreter";
+    Variant variant = Variant::Nmos;
+    bool lockstep = false;
+    u16 entry = 0x0400;
+    std::optional<u16> success = 0x3469;
+    u64 limit = 1000000000;
+    u32 failures = 5;
+};
+
+static constexpr u64 Slice = 100000;
+
+static auto Testable(u8 opcode, Variant variant) -> bool
+{
+    Operation operation = GetInstructions(variant)[opcode].operation;
+    return operation != Operation::JAM && operation != Operation::STP && operation != Operation::WAI;
+}
+
+static auto Interrupting(Engine engine, InterruptController& interrupts) -> Engine
+{
+    return [engine = std::move(engine), &interrupts](CPU& cpu, Memory& memory, u64 instructions)
+    {
+        cpu.Attach(interrupts);
+        return engine(cpu, memory, instructions);
+    };
+}
+
+static auto PrintRegisters(const char* label, const Registers& registers, u64 cycles) -> void
+{
+    std::printf("  %-9s PC=$%04X A=$%02X X=$%02X Y=$%02X SP=$%02X PS=$%02X cycles=%llu\n", label, registers.PC, registers.A, registers.X, registers.Y, registers.SP, registers.PS, cycles);
+}
+
+static auto RunFunctional(const std::filesystem::path& path, const Options& options, Engines& engines) -> bool
+{
+    Image image;
+    Loader::Load(image, path, ImageFormat::Binary, 0x0000);
+
+    CPU cpu;
+    Memory memory;
+    InterruptController interrupts;
+    memory.Map(image);
+    cpu.Attach(interrupts);
+
+    Registers registers = cpu.GetRegisters();
+    registers.PC = options.entry;
+    cpu.SetRegisters(registers);
+
+    Engine engine = engines.Get(options.engine);
+    u64 instructions = 0;
+    while (instructions < options.limit)
+    {
+        instructions += engine(cpu, memory, Slice).instructions;
+        u16 pc = cpu.GetRegisters().PC;
+        instructions += engine(cpu, memory, 1).instructions;
+        if (cpu.GetRegisters().PC == pc)
+        {
+            break;
+        }
+    }
+
+    registers = cpu.GetRegisters();
+    bool passed = options.success.has_value() ? registers.PC == *options.success : instructions < options.limit;
+    std::printf("%s: %s, trapped at $%04X (%s) after %llu instructions and %llu cycles\n", path.string().c_str(), passed ? "passed" : "FAILED", registers.PC, Disassembler::Disassemble(memory, registers.PC, options.variant).c_str(), instructions, cpu.GetCycles());
+    if (!passed)
+    {
+        PrintRegisters("state", registers, cpu.GetCycles());
+    }
+
+    if (!options.lockstep)
+    {
+        return passed;
+    }
+
+    InterruptController referenceInterrupts;
+    InterruptController candidateInterrupts;
+    Lockstep lockstep(Interrupting(engines.Get("interpreter"), referenceInterrupts), Interrupting(engines.Get(options.engine), candidateInterrupts), Slice);
+    std::optional<Divergence> divergence = lockstep.Run(image, options.entry, instructions);
+    if (!divergence.has_value())
+    {
+        std::printf("%s: %s matches the interpreter for %llu instructions\n", path.string().c_str(), options.engine.c_str(), instructions);
+        return passed;
+    }
+
+    std::printf("%s: %s diverges from the interpreter within %llu instructions\n", path.string().c_str(), options.engine.c_str(), divergence->instructions);
+    PrintRegisters("expected", divergence->expected, divergence->expectedCycles);
+    PrintRegisters("actual", divergence->actual, divergence->actualCycles);
+    if (divergence->address.has_value())
+    {
+        std::printf("  memory differs at $%04X\n", *divergence->address);
+    }
+    return false;
+}
+
+static auto Load(Memory& memory, const Json& state) -> Registers
+{
+    memory.Reset();
+    for (const Json& cell : state["ram"].items)
+    {
+        memory.Write(cell.items.at(0).number, cell.items.at(1).number);
+    }
+    return { static_cast<u16>(state["pc"].number), static_cast<u8>(state["s"].number), static_cast<u8>(state["a"].number), static_cast<u8>(state["x"].number), static_cast<u8>(state["y"].number), static_cast<u8>(state["p"].number & ~0x10) };
+}
+
+static auto Check(const Memory& memory, const CPU& cpu, const Json& state, u64 cycles, std::string& error) -> bool
+{
+    Registers actual = cpu.GetRegisters();
+    Registers expected = { static_cast<u16>(state["pc"].number), static_cast<u8>(state["s"].number), static_cast<u8>(state["a"].number), static_cast<u8>(state["x"].number), static_cast<u8>(state["y"].number), static_cast<u8>(state["p"].number) };
+
+    char line[160];
+    if (actual.PC != expected.PC || actual.SP != expected.SP || actual.A != expected.A || actual.X != expected.X || actual.Y != expected.Y || (actual.PS & 0xCF) != (expected.PS & 0xCF))
+    {
+        std::snprintf(line, sizeof(line), "registers PC=$%04X A=$%02X X=$%02X Y=$%02X SP=$%02X PS=$%02X, expected PC=$%04X A=$%02X X=$%02X Y=$%02X SP=$%02X PS=$%02X", actual.PC, actual.A, actual.X, actual.Y, actual.SP, actual.PS, expected.PC, expected.A, expected.X, expected.Y, expected.SP, expected.PS);
+        error = line;
+        return false;
+    }
+
+    for (const Json& cell : state["ram"].items)
+    {
+        u16 address = cell.items.at(0).number;
+        u8 value = cell.items.at(1).number;
+        if (memory.Read(address) != value)
+        {
+            std::snprintf(line, sizeof(line), "memory $%04X=$%02X, expected $%02X", address, memory.Read(address), value);
+            error = line;
+            return false;
+        }
+    }
+
+    if (cpu.GetCycles() != cycles)
+    {
+        std::snprintf(line, sizeof(line), "%llu cycles, expected %llu", cpu.GetCycles(), cycles);
+        error = line;
+        return false;
+    }
+    return true;
+}
+
+static auto RunVectors(const std::filesystem::path& path, const Options& options, Engines& engines) -> bool
+{
+    MappedFile file(path);
+    Json tests = JsonParser(file.GetData()).Parse();
+
+    CPU cpu;
+    Memory memory;
+    InterruptController interrupts;
+    cpu.Attach(interrupts);
+    Engine engine = engines.Get(options.engine);
+
+    u64 passed = 0;
+    u64 failed = 0;
+    u64 skipped = 0;
+    for (const Json& test : tests.items)
+    {
+        const Json& initial = test["initial"];
+        Registers registers = Load(memory, initial);
+        if (!Testable(memory.Read(registers.PC), options.variant))
+        {
+            skipped++;
+            continue;
+        }
+
+        cpu.Reset();
+        interrupts.Reset();
+        cpu.SetRegisters(registers);
+        engine(cpu, memory, 1);
+
+        std::string error;
+        if (Check(memory, cpu, test["final"], test["cycles"].items.size(), error))
+        {
+            passed++;
+            continue;
+        }
+
+        if (failed++ < options.failures)
+        {
+            Load(memory, initial);
+            std::printf("  %s: %s: %s\n", test["name"].text.c_str(), Disassembler::Disassemble(memory, registers.PC, options.variant).c_str(), error.c_str());
+        }
+    }
+
+    std::printf("%s: %llu passed, %llu failed, %llu skipped\n", path.string().c_str(), passed, failed, skipped);
+    return failed == 0;
+}
+
+static auto Collect(const std::filesystem::path& path) -> std::vector<std::filesystem::path>
+{
+    if (!std::filesystem::is_directory(path))
+    {
+        return { path };
+    }
+
+    std::vector<std::filesystem::path> paths;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(path))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".json")
+        {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+static auto ParseNumber(const std::string& text) -> u64
+{
+    return std::stoull(text, nullptr, 0);
+}
+
+static auto ParseVariant(const std::string& text) -> Variant
+{
+    if (text == "nmos")
+    {
+        return Variant::Nmos;
+    }
+    if (text == "cmos")
+    {
+        return Variant::Cmos;
+    }
+    if (text == "strict")
+    {
+        return Variant::Strict;
+    }
+    throw std::runtime_error("unknown variant " + text);
+}
+
+static auto Usage(const char* program) -> int
+{
+    std::fprintf(stderr, "usage: %s functional [--engine NAME] [--variant NAME] [--lockstep] [--entry ADDRESS] [--success ADDRESS|none] [--limit INSTRUCTIONS] ROM\n", program);
+    std::fprintf(stderr, "       %s vectors [--engine NAME] [--variant NAME] [--failures COUNT] FILE|DIRECTORY...\n", program);
+    std::fprintf(stderr, "engines: interpreter, blocks, jit\n");
+    std::fprintf(stderr, "variants: nmos, cmos, strict\n");
+    return 2;
+}
+
+auto main(int argc, char** argv) -> int
+{
+    if (argc < 3)
+    {
+        return Usage(argv[0]);
+    }
+
+    std::string mode = argv[1];
+    if (mode != "functional" && mode != "vectors")
+    {
+        return Usage(argv[0]);
+    }
+
+    Options options;
+    std::vector<std::filesystem::path> paths;
+    try
+    {
+        for (int index = 2; index < argc; index++)
+        {
+            std::string argument = argv[index];
+            bool value = index + 1 < argc;
+            if (argument == "--engine" && value)
+            {
+                options.engine = argv[++index];
+            }
+            else if (argument == "--variant" && value)
+            {
+                options.variant = ParseVariant(argv[++index]);
+            }
+            else if (argument == "--lockstep")
+            {
+                options.lockstep = true;
+            }
+            else if (argument == "--entry" && value)
+            {
+                options.entry = ParseNumber(argv[++index]);
+            }
+            else if (argument == "--success" && value)
+            {
+                std::string success = argv[++index];
+                options.success = success == "none" ? std::nullopt : std::optional<u16>(ParseNumber(success));
+            }
+            else if (argument == "--limit" && value)
+            {
+                options.limit = ParseNumber(argv[++index]);
+            }
+            else if (argument == "--failures" && value)
+            {
+                options.failures = ParseNumber(argv[++index]);
+            }
+            else if (argument.starts_with("-"))
+            {
+                return Usage(argv[0]);
+            }
+            else
+            {
+                std::vector<std::filesystem::path> collected = Collect(argument);
+                paths.insert(paths.end(), collected.begin(), collected.end());
+            }
+        }
+
+        Engines engines(options.variant);
+        bool passed = true;
+        for (const std::filesystem::path& path : paths)
+        {
+            passed = (mode == "functional" ? RunFunctional(path, options, engines) : RunVectors(path, options, engines)) && passed;
+        }
+        return passed ? 0 : 1;
+    }
+    catch (const std::exception& exception)
+    {
+        std::fprintf(stderr, "%s\n", exception.what());
+        return 2;
+    }
+}
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cpu.hh>
+#include <fuzzer.hh>
+#include <loader.hh>
+#include <memory.hh>
+
+struct Options
+{
+    FuzzOptions fuzz;
+    std::vector<FuzzRegion> regions;
+    std::optional<u16> entry;
+    std::optional<u16> start;
+    u64 seconds = 0;
+    std::optional<std::filesystem::path> corpus;
+    std::optional<std::filesystem::path> findings;
+};
+
+static constexpr u64 WarmupLimit = 100000000;
+
+static auto ParseNumber(const std::string& text) -> u64
+{
+    return std::stoull(text, nullptr, 0);
+}
+
+static auto ParseAddress(const std::string& text) -> u16
+{
+    u64 value = ParseNumber(text);
+    if (value > 0xFFFF)
+    {
+        throw std::out_of_range("address out of range: " + text);
+    }
+    return value;
+}
+
+static auto ParseRegion(const std::string& text) -> FuzzRegion
+{
+    u64 separator = text.find(':');
+    if (separator == std::string::npos)
+    {
+        throw std::runtime_error("expected ADDRESS:SIZE, got " + text);
+    }
+    return { ParseAddress(text.substr(0, separator)), static_cast<u16>(ParseNumber(text.substr(separator + 1))) };
+}
+
+static auto ParseVariant(const std::string& text) -> Variant
+{
+    if (text == "nmos")
+    {
+        return Variant::Nmos;
+    }
+    if (text == "cmos")
+    {
+        return Variant::Cmos;
+    }
+    if (text == "strict")
+    {
+        return Variant::Strict;
+    }
+    throw std::runtime_error("unknown variant " + text);
+}
+
+static auto Describe(StopReason reason) -> const char*
+{
+    switch (reason)
+    {
+        case StopReason::Break:
+            return "break";
+        case StopReason::InstructionLimit:
+            return "instructions";
+        case StopReason::CycleLimit:
+            return "cycles";
+        default:
+            return "illegal";
+    }
+}
+
+static auto Warm(CPU& cpu, Memory& memory, Variant variant, u16 start) -> void
+{
+    for (u64 instructions = 0; cpu.GetRegisters().PC != start; instructions++)
+    {
+        RunResult result;
+        switch (variant)
+        {
+            case Variant::Cmos:
+                result = cpu.Step<Variant::Cmos>(memory);
+                break;
+            case Variant::Strict:
+                result = cpu.Step<Variant::Strict>(memory);
+                break;
+            default:
+                result = cpu.Step<Variant::Nmos>(memory);
+                break;
+        }
+
+        if (result.reason != StopReason::InstructionLimit || instructions == WarmupLimit)
+        {
+            char line[96];
+            std::snprintf(line, sizeof(line), "did not reach $%04X, stopped at $%04X", start, cpu.GetRegisters().PC);
+            throw std::runtime_error(line);
+        }
+    }
+}
+
+static auto Write(const std::filesystem::path& path, const std::vector<u8>& data) -> void
+{
+    std::ofstream stream(path, std::ios::binary);
+    stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!stream)
+    {
+        throw std::runtime_error("cannot write " + path.string());
+    }
+}
+
+static auto Usage(const char* program) -> int
+{
+    std::fprintf(stderr, "usage: %s --input ADDRESS:SIZE [--input ADDRESS:SIZE]... [--entry ADDRESS] [--start ADDRESS] [--variant NAME] [--limit INSTRUCTIONS] [--threads COUNT] [--seed NUMBER] [--time SECONDS] [--corpus DIRECTORY] [--findings DIRECTORY] IMAGE[@ADDRESS]...\n", program);
+    std::fprintf(stderr, "variants: nmos, cmos, strict\n");
+    return 2;
+}
+
+auto main(int argc, char** argv) -> int
+{
+    Options options;
+    Image image;
+    std::optional<u16> first;
+    bool loaded = false;
+
+    try
+    {
+        for (int index = 1; index < argc; index++)
+        {
+            std::string argument = argv[index];
+            bool value = index + 1 < argc;
+            if (argument == "--input" && value)
+            {
+                options.regions.push_back(ParseRegion(argv[++index]));
+            }
+            else if (argument == "--entry" && value)
+            {
+                options.entry = ParseAddress(argv[++index]);
+            }
+            else if (argument == "--start" && value)
+            {
+                options.start = ParseAddress(argv[++index]);
+            }
+            else if (argument == "--variant" && value)
+            {
+                options.fuzz.variant = ParseVariant(argv[++index]);
+            }
+            else if (argument == "--limit" && value)
+            {
+                options.fuzz.instructions = ParseNumber(argv[++index]);
+            }
+            else if (argument == "--threads" && value)
+            {
+                options.fuzz.threads = ParseNumber(argv[++index]);
+            }
+            else if (argument == "--seed" && value)
+            {
+                options.fuzz.seed = ParseNumber(argv[++index]);
+            }
+            else if (argument == "--time" && value)
+            {
+                options.seconds = ParseNumber(argv[++index]);
+            }
+            else if (argument == "--corpus" && value)
+            {
+                options.corpus = argv[++index];
+            }
+            else if (argument == "--findings" && value)
+            {
+                options.findings = argv[++index];
+            }
+            else if (argument.starts_with("-"))
+            {
+                return Usage(argv[0]);
+            }
+            else
+            {
+                u16 address = 0x0000;
+                u64 separator = argument.rfind('@');
+                if (separator != std::string::npos)
+                {
+                    address = ParseAddress(argument.substr(separator + 1));
+                    argument.resize(separator);
+                }
+
+                ImageFormat format = Loader::Detect(argument);
+                std::optional<u16> origin = Loader::Load(image, argument, format, address);
+                loaded = true;
+                if (!first.has_value())
+                {
+                    first = origin;
+                }
+            }
+        }
+
+        if (!loaded || options.regions.empty())
+        {
+            return Usage(argv[0]);
+        }
+
+        bool vector = image.GetPage(CPU::ResetVector >> 8) != nullptr;
+        if (!options.entry.has_value() && !vector && !first.has_value())
+        {
+            throw std::runtime_error("the images have no reset vector and no data to start at, pass --entry");
+        }
+
+        CPU cpu;
+        Memory memory;
+        memory.Map(image);
+        if (vector)
+        {
+            cpu.Reset(memory);
+        }
+
+        Registers registers = cpu.GetRegisters();
+        if (options.entry.has_value() || !vector)
+        {
+            registers.PC = options.entry.value_or(*first);
+            cpu.SetRegisters(registers);
+        }
+
+        if (options.start.has_value())
+        {
+            Warm(cpu, memory, options.fuzz.variant, *options.start);
+        }
+
+        Fuzzer fuzzer(cpu, memory, options.regions, options.fuzz);
+        if (options.corpus.has_value() && std::filesystem::is_directory(*options.corpus))
+        {
+            for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(*options.corpus))
+            {
+                if (entry.is_regular_file())
+                {
+                    MappedFile file(entry.path());
+                    fuzzer.AddSeed(file.GetData());
+                }
+            }
+        }
+
+        std::printf("fuzzing %u input bytes on %u threads from $%04X\n", fuzzer.GetInputSize(), fuzzer.GetThreadCount(), cpu.GetRegisters().PC);
+
+        FuzzStatistics last = {};
+        FuzzStatistics statistics = fuzzer.Run(std::chrono::seconds(options.seconds), [&last](const FuzzStatistics& current)
+        {
+            double rate = current.seconds > last.seconds ? (current.executions - last.executions) / (current.seconds - last.seconds) : 0.0;
+            std::printf("[%7.1fs] executions %12llu %10.0f/s  edges %6llu (+%llu)  corpus %6llu  findings %4llu  timeouts %llu\n", current.seconds, current.executions, rate, current.edges, current.edges - last.edges, current.corpus, current.findings, current.timeouts);
+            std::fflush(stdout);
+            last = current;
+        });
+
+        std::printf("done: %llu executions in %.1fs (%.0f/s), %llu edges, %llu corpus entries, %llu findings, %llu timeouts\n", statistics.executions, statistics.seconds, statistics.seconds > 0 ? statistics.executions / statistics.seconds : 0.0, statistics.edges, statistics.corpus, statistics.findings, statistics.timeouts);
+
+        if (options.corpus.has_value())
+        {
+            std::filesystem::create_directories(*options.corpus);
+            std::vector<std::vector<u8>> corpus = fuzzer.GetCorpus();
+            for (u64 index = 0; index < corpus.size(); index++)
+            {
+                char name[32];
+                std::snprintf(name, sizeof(name), "%06llu.bin", index);
+                Write(*options.corpus / name, corpus[index]);
+            }
+        }
+
+        for (const FuzzFinding& finding : fuzzer.GetFindings())
+        {
+            std::printf("finding: %s at $%04X\n", Describe(finding.reason), finding.PC);
+            if (options.findings.has_value())
+            {
+                std::filesystem::create_directories(*options.findings);
+                char name[32];
+                std::snprintf(name, sizeof(name), "%s-%04X.bin", Describe(finding.reason), finding.PC);
+                Write(*options.findings / name, finding.input);
+            }
+        }
+
+        return statistics.findings != 0 ? 1 : 0;
+    }
+    catch (const std::exception& exception)
+    {
+        std::fprintf(stderr, "%s\n", exception.what());
+        return 2;
+    }
+}
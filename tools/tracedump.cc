@@ -0,0 +1,36 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <disassembler.hh>
+#include <opcodes.hh>
+#include <trace.hh>
+
+auto main(int argc, char** argv) -> int
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "usage: %s TRACE\n", argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        Variant variant;
+        std::vector<TraceRecord> records = Trace::Load(argv[1], variant);
+        const Instruction* instructions = GetInstructions(variant);
+        for (const TraceRecord& record : records)
+        {
+            u8 length = Length(instructions[record.opcode].addressingMode);
+            char bytes[9] = {};
+            std::snprintf(bytes, sizeof(bytes), length == 1 ? "%02X" : length == 2 ? "%02X %02X" : "%02X %02X %02X", record.opcode, record.operand & 0xFF, record.operand >> 8);
+            std::string text = Disassembler::Disassemble(record.PC, record.opcode, record.operand, variant);
+            std::printf("%12llu  %04X  %-8s  %-12s  A=%02X X=%02X Y=%02X SP=%02X PS=%02X\n", static_cast<unsigned long long>(record.cycles), static_cast<unsigned>(record.PC), bytes, text.c_str(), record.A, record.X, record.Y, record.SP, record.PS);
+        }
+    }
+    catch (const std::exception& exception)
+    {
+        std::fprintf(stderr, "%s\n", exception.what());
+        return 1;
+    }
+    return 0;
+}